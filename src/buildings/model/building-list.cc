@@ -25,6 +25,9 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include "building-list.h"
 #include "building.h"
 
@@ -47,6 +50,9 @@ public:
   BuildingList::Iterator End (void) const;
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
+  void GetBuildingsContaining (const Vector &position, std::vector<Ptr<Building> > &buildings);
+  void GetBuildingsIntersecting (const Vector &a, const Vector &b, std::vector<Ptr<Building> > &buildings);
+  void InvalidateIndex (void);
 
   static Ptr<BuildingListPriv> Get (void);
 
@@ -54,7 +60,39 @@ private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+  /**
+   * Build the grid of the footprints of the buildings.
+   */
+  void BuildIndex (void);
+  /**
+   * \param x a coordinate along the x axis
+   * \returns the column of the grid of x, clamped to the grid
+   */
+  uint32_t GetColumn (double x) const;
+  /**
+   * \param y a coordinate along the y axis
+   * \returns the row of the grid of y, clamped to the grid
+   */
+  uint32_t GetRow (double y) const;
+  /**
+   * Append to m_candidates the buildings of a cell which are not yet there.
+   * \param cell the index of the cell
+   */
+  void AddCandidates (uint32_t cell);
+
   std::vector<Ptr<Building> > m_buildings;
+  bool m_indexValid;                            //!< whether m_cells is up to date
+  double m_xMin;                                //!< lower x boundary of the grid
+  double m_yMin;                                //!< lower y boundary of the grid
+  double m_xMax;                                //!< upper x boundary of the grid
+  double m_yMax;                                //!< upper y boundary of the grid
+  double m_cellSize;                            //!< side of the cells of the grid
+  uint32_t m_nColumns;                          //!< number of columns of the grid
+  uint32_t m_nRows;                             //!< number of rows of the grid
+  std::vector<std::vector<uint32_t> > m_cells;  //!< ids of the buildings overlapping each cell, row after row
+  std::vector<uint32_t> m_candidates;           //!< buildings found by the current query
+  std::vector<uint32_t> m_lastQuery;            //!< last query which found each building
+  uint32_t m_query;                             //!< number of the current query
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +138,8 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false),
+    m_query (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +158,7 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  InvalidateIndex ();
   Object::DoDispose ();
 }
 
@@ -127,6 +168,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  InvalidateIndex ();
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +197,224 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::InvalidateIndex (void)
+{
+  m_indexValid = false;
+  m_cells.clear ();
+}
+
+void
+BuildingListPriv::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_indexValid = true;
+  m_cells.clear ();
+  m_lastQuery.assign (m_buildings.size (), 0);
+  m_query = 0;
+  if (m_buildings.empty ())
+    {
+      m_nColumns = 0;
+      m_nRows = 0;
+      return;
+    }
+
+  m_xMin = m_yMin = std::numeric_limits<double>::infinity ();
+  m_xMax = m_yMax = -std::numeric_limits<double>::infinity ();
+  double sumSizes = 0;
+  for (std::vector<Ptr<Building> >::const_iterator it = m_buildings.begin (); it != m_buildings.end (); ++it)
+    {
+      Box box = (*it)->GetBoundaries ();
+      m_xMin = std::min (m_xMin, box.xMin);
+      m_yMin = std::min (m_yMin, box.yMin);
+      m_xMax = std::max (m_xMax, box.xMax);
+      m_yMax = std::max (m_yMax, box.yMax);
+      sumSizes += std::max (box.xMax - box.xMin, box.yMax - box.yMin);
+    }
+
+  // about one building per cell, but cells at least as large as the
+  // buildings on average, so that a building overlaps only a few cells
+  double n = m_buildings.size ();
+  double width = m_xMax - m_xMin;
+  double height = m_yMax - m_yMin;
+  m_cellSize = std::max (std::sqrt (width * height / n), sumSizes / n);
+  m_cellSize = std::max (m_cellSize, std::max (width, height) / (4 * n));
+  if (m_cellSize == 0)
+    {
+      // all the buildings have an empty footprint at the same position
+      m_cellSize = 1;
+    }
+  m_nColumns = static_cast<uint32_t> (std::floor (width / m_cellSize)) + 1;
+  m_nRows = static_cast<uint32_t> (std::floor (height / m_cellSize)) + 1;
+  NS_LOG_LOGIC ("grid of " << m_nColumns << "x" << m_nRows << " cells of " << m_cellSize << " m");
+
+  m_cells.resize (m_nColumns * m_nRows);
+  for (uint32_t id = 0; id < m_buildings.size (); ++id)
+    {
+      Box box = m_buildings[id]->GetBoundaries ();
+      uint32_t lastColumn = GetColumn (box.xMax);
+      uint32_t lastRow = GetRow (box.yMax);
+      for (uint32_t row = GetRow (box.yMin); row <= lastRow; ++row)
+        {
+          for (uint32_t column = GetColumn (box.xMin); column <= lastColumn; ++column)
+            {
+              m_cells[row * m_nColumns + column].push_back (id);
+            }
+        }
+    }
+}
+
+uint32_t
+BuildingListPriv::GetColumn (double x) const
+{
+  double column = std::floor ((x - m_xMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (column, 0.0), m_nColumns - 1.0));
+}
+
+uint32_t
+BuildingListPriv::GetRow (double y) const
+{
+  double row = std::floor ((y - m_yMin) / m_cellSize);
+  return static_cast<uint32_t> (std::min (std::max (row, 0.0), m_nRows - 1.0));
+}
+
+void
+BuildingListPriv::AddCandidates (uint32_t cell)
+{
+  const std::vector<uint32_t> &ids = m_cells[cell];
+  for (std::vector<uint32_t>::const_iterator it = ids.begin (); it != ids.end (); ++it)
+    {
+      if (m_lastQuery[*it] != m_query)
+        {
+          m_lastQuery[*it] = m_query;
+          m_candidates.push_back (*it);
+        }
+    }
+}
+
+void
+BuildingListPriv::GetBuildingsContaining (const Vector &position, std::vector<Ptr<Building> > &buildings)
+{
+  NS_LOG_FUNCTION (this << position);
+  buildings.clear ();
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  if (m_buildings.empty ()
+      || position.x < m_xMin || position.x > m_xMax
+      || position.y < m_yMin || position.y > m_yMax)
+    {
+      return;
+    }
+  // the ids of a cell are sorted
+  const std::vector<uint32_t> &ids = m_cells[GetRow (position.y) * m_nColumns + GetColumn (position.x)];
+  for (std::vector<uint32_t>::const_iterator it = ids.begin (); it != ids.end (); ++it)
+    {
+      if (m_buildings[*it]->IsInside (position))
+        {
+          buildings.push_back (m_buildings[*it]);
+        }
+    }
+}
+
+void
+BuildingListPriv::GetBuildingsIntersecting (const Vector &a, const Vector &b, std::vector<Ptr<Building> > &buildings)
+{
+  NS_LOG_FUNCTION (this << a << b);
+  buildings.clear ();
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  if (m_buildings.empty ())
+    {
+      return;
+    }
+
+  // clip the projection of the segment on the grid
+  double t0 = 0;
+  double t1 = 1;
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  const double from[2] = { a.x, a.y };
+  const double d[2] = { dx, dy };
+  const double min[2] = { m_xMin, m_yMin };
+  const double max[2] = { m_xMax, m_yMax };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      if (d[i] == 0)
+        {
+          if (from[i] < min[i] || from[i] > max[i])
+            {
+              return;
+            }
+          continue;
+        }
+      double tMin = (min[i] - from[i]) / d[i];
+      double tMax = (max[i] - from[i]) / d[i];
+      t0 = std::max (t0, std::min (tMin, tMax));
+      t1 = std::min (t1, std::max (tMin, tMax));
+    }
+  if (t0 > t1)
+    {
+      return;
+    }
+
+  // walk through the cells crossed by the segment, in grid units
+  if (++m_query == 0)
+    {
+      // wrapped around
+      std::fill (m_lastQuery.begin (), m_lastQuery.end (), 0);
+      m_query = 1;
+    }
+  m_candidates.clear ();
+  double x = (a.x + t0 * dx - m_xMin) / m_cellSize;
+  double y = (a.y + t0 * dy - m_yMin) / m_cellSize;
+  double gx = (t1 - t0) * dx / m_cellSize;
+  double gy = (t1 - t0) * dy / m_cellSize;
+  int64_t column = GetColumn (a.x + t0 * dx);
+  int64_t row = GetRow (a.y + t0 * dy);
+  int64_t lastColumn = GetColumn (a.x + t1 * dx);
+  int64_t lastRow = GetRow (a.y + t1 * dy);
+  int stepX = gx > 0 ? 1 : (gx < 0 ? -1 : 0);
+  int stepY = gy > 0 ? 1 : (gy < 0 ? -1 : 0);
+  double infinity = std::numeric_limits<double>::infinity ();
+  double tDeltaX = stepX != 0 ? 1 / std::abs (gx) : infinity;
+  double tDeltaY = stepY != 0 ? 1 / std::abs (gy) : infinity;
+  double tMaxX = stepX > 0 ? (column + 1 - x) / gx : (stepX < 0 ? (x - column) / -gx : infinity);
+  double tMaxY = stepY > 0 ? (row + 1 - y) / gy : (stepY < 0 ? (y - row) / -gy : infinity);
+  AddCandidates (row * m_nColumns + column);
+  while (column != lastColumn || row != lastRow)
+    {
+      if (tMaxX < tMaxY)
+        {
+          column += stepX;
+          tMaxX += tDeltaX;
+        }
+      else
+        {
+          row += stepY;
+          tMaxY += tDeltaY;
+        }
+      if (column < 0 || column >= m_nColumns || row < 0 || row >= m_nRows)
+        {
+          // rounding error at the end of the segment
+          break;
+        }
+      AddCandidates (row * m_nColumns + column);
+    }
+
+  std::sort (m_candidates.begin (), m_candidates.end ());
+  for (std::vector<uint32_t>::const_iterator it = m_candidates.begin (); it != m_candidates.end (); ++it)
+    {
+      if (m_buildings[*it]->IsIntersect (a, b))
+        {
+          buildings.push_back (m_buildings[*it]);
+        }
+    }
+}
+
 }
 
 /**
@@ -189,5 +449,20 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+void
+BuildingList::GetBuildingsContaining (Vector position, std::vector<Ptr<Building> > &buildings)
+{
+  BuildingListPriv::Get ()->GetBuildingsContaining (position, buildings);
+}
+void
+BuildingList::GetBuildingsIntersecting (Vector a, Vector b, std::vector<Ptr<Building> > &buildings)
+{
+  BuildingListPriv::Get ()->GetBuildingsIntersecting (a, b, buildings);
+}
+void
+BuildingList::InvalidateIndex (void)
+{
+  BuildingListPriv::Get ()->InvalidateIndex ();
+}
 
 } // namespace ns3
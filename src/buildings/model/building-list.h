@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,35 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+  /**
+   * \param position a position
+   * \param buildings the buildings which contain the position, by
+   *        increasing id
+   *
+   * The buildings are looked up in a uniform grid over their footprints,
+   * which is built at the first query, so the cost of the query does not
+   * depend on the number of buildings.
+   */
+  static void GetBuildingsContaining (Vector position, std::vector<Ptr<Building> > &buildings);
+  /**
+   * \param a the first end of a segment
+   * \param b the second end of the segment
+   * \param buildings the buildings which the segment intersects, by
+   *        increasing id
+   *
+   * Only the cells of the grid of the buildings which the segment goes
+   * through are visited.
+   */
+  static void GetBuildingsIntersecting (Vector a, Vector b, std::vector<Ptr<Building> > &buildings);
+  /**
+   * Discard the grid of the buildings, which will be built again at the
+   * next query.
+   *
+   * This method is called automatically when a building is added or its
+   * boundaries are changed, so the user has little reason to call it
+   * himself.
+   */
+  static void InvalidateIndex (void);
 };
 
 } // namespace ns3
@@ -28,6 +28,8 @@
 #include <ns3/log.h>
 #include <ns3/assert.h>
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -140,6 +142,7 @@ Building::SetBoundaries (Box boundaries)
 {
   NS_LOG_FUNCTION (this << boundaries);
   m_buildingBounds = boundaries;
+  BuildingList::InvalidateIndex ();
 }
 
 void
@@ -285,4 +288,102 @@ Building::GetFloor (Vector position) const
 }
 
 
+bool
+Building::Clip (const Vector &a, const Vector &b, double &tEnter, double &tExit) const
+{
+  const double from[3] = { a.x, a.y, a.z };
+  const double to[3] = { b.x, b.y, b.z };
+  const double min[3] = { m_buildingBounds.xMin, m_buildingBounds.yMin, m_buildingBounds.zMin };
+  const double max[3] = { m_buildingBounds.xMax, m_buildingBounds.yMax, m_buildingBounds.zMax };
+  tEnter = -std::numeric_limits<double>::infinity ();
+  tExit = std::numeric_limits<double>::infinity ();
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      double d = to[i] - from[i];
+      if (d == 0)
+        {
+          if (from[i] < min[i] || from[i] > max[i])
+            {
+              return false;
+            }
+          continue;
+        }
+      double t1 = (min[i] - from[i]) / d;
+      double t2 = (max[i] - from[i]) / d;
+      tEnter = std::max (tEnter, std::min (t1, t2));
+      tExit = std::min (tExit, std::max (t1, t2));
+    }
+  return tEnter <= tExit && tExit >= 0 && tEnter <= 1;
+}
+
+uint32_t
+Building::GetRoomIndex (double x, double min, double max, uint16_t nRooms)
+{
+  if (x >= max)
+    {
+      return nRooms - 1;
+    }
+  if (x <= min)
+    {
+      return 0;
+    }
+  return std::min<uint32_t> (floor (nRooms * (x - min) / (max - min)), nRooms - 1);
+}
+
+bool
+Building::IsIntersect (Vector a, Vector b) const
+{
+  double tEnter;
+  double tExit;
+  return Clip (a, b, tEnter, tExit);
+}
+
+uint32_t
+Building::GetNExternalWallsCrossed (Vector a, Vector b) const
+{
+  NS_LOG_FUNCTION (this << a << b);
+  double tEnter;
+  double tExit;
+  if (!Clip (a, b, tEnter, tExit))
+    {
+      return 0;
+    }
+  uint32_t n = 0;
+  if (tEnter > 0)
+    {
+      n++;
+    }
+  if (tExit < 1)
+    {
+      n++;
+    }
+  return n;
+}
+
+uint32_t
+Building::GetNInternalWallsCrossed (Vector a, Vector b) const
+{
+  NS_LOG_FUNCTION (this << a << b);
+  double tEnter;
+  double tExit;
+  if (!Clip (a, b, tEnter, tExit))
+    {
+      return 0;
+    }
+  // the part of the segment inside the building
+  double t0 = std::max (tEnter, 0.0);
+  double t1 = std::min (tExit, 1.0);
+  double x0 = a.x + t0 * (b.x - a.x);
+  double x1 = a.x + t1 * (b.x - a.x);
+  double y0 = a.y + t0 * (b.y - a.y);
+  double y1 = a.y + t1 * (b.y - a.y);
+  // as the segment is straight, it crosses every wall between its end rooms
+  uint32_t roomX0 = GetRoomIndex (x0, m_buildingBounds.xMin, m_buildingBounds.xMax, m_roomsX);
+  uint32_t roomX1 = GetRoomIndex (x1, m_buildingBounds.xMin, m_buildingBounds.xMax, m_roomsX);
+  uint32_t roomY0 = GetRoomIndex (y0, m_buildingBounds.yMin, m_buildingBounds.yMax, m_roomsY);
+  uint32_t roomY1 = GetRoomIndex (y1, m_buildingBounds.yMin, m_buildingBounds.yMax, m_roomsY);
+  return std::max (roomX0, roomX1) - std::min (roomX0, roomX1)
+         + std::max (roomY0, roomY1) - std::min (roomY0, roomY1);
+}
+
 } // namespace ns3
@@ -201,10 +201,62 @@ public:
    */
   uint16_t GetFloor (Vector position) const;
 
+  /** 
+   * 
+   * \param a the first end of a segment
+   * \param b the second end of the segment
+   * 
+   * \return true if the segment intersects the building, false otherwise
+   */
+  bool IsIntersect (Vector a, Vector b) const;
+
+  /** 
+   * 
+   * \param a the first end of a segment
+   * \param b the second end of the segment
+   * 
+   * \return the number of times the segment crosses the boundaries of
+   * the building, i.e., 0 if the segment is outside or inside the
+   * building, 1 if only one end is inside the building and 2 if the
+   * segment goes through the building
+   */
+  uint32_t GetNExternalWallsCrossed (Vector a, Vector b) const;
+
+  /** 
+   * 
+   * \param a the first end of a segment
+   * \param b the second end of the segment
+   * 
+   * \return the number of walls between the rooms that the part of the
+   * segment inside the building crosses
+   */
+  uint32_t GetNInternalWallsCrossed (Vector a, Vector b) const;
+
 
 
 
 private:
+  /** 
+   * Intersect the line going through a segment with the building
+   * 
+   * \param a the first end of the segment
+   * \param b the second end of the segment
+   * \param tEnter the position a + tEnter * (b - a) where the line enters the building
+   * \param tExit the position a + tExit * (b - a) where the line exits the building
+   * 
+   * \return true if the segment intersects the building
+   */
+  bool Clip (const Vector &a, const Vector &b, double &tEnter, double &tExit) const;
+
+  /** 
+   * \param x a coordinate
+   * \param min the lower boundary of the building along the axis of x
+   * \param max the upper boundary of the building along the axis of x
+   * \param nRooms the number of rooms along the axis of x
+   * 
+   * \return the index, starting from 0, of the room along the axis of x
+   */
+  static uint32_t GetRoomIndex (double x, double min, double max, uint16_t nRooms);
 
   Box m_buildingBounds;
 
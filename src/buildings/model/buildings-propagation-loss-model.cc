@@ -101,27 +101,26 @@ BuildingsPropagationLossModel::BuildingsPropagationLossModel ()
 }
 
 double
-BuildingsPropagationLossModel::ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const
+BuildingsPropagationLossModel::GetExternalWallLoss (Building::ExtWallsType_t type)
 {
-  double loss = 0.0;
-  Ptr<Building> aBuilding = a->GetBuilding ();
-  if (aBuilding->GetExtWallsType () == Building::Wood)
-    {
-      loss = 4;
-    }
-  else if (aBuilding->GetExtWallsType () == Building::ConcreteWithWindows)
-    {
-      loss = 7;
-    }
-  else if (aBuilding->GetExtWallsType () == Building::ConcreteWithoutWindows)
-    {
-      loss = 15; // 10 ~ 20 dB
-    }
-  else if (aBuilding->GetExtWallsType () == Building::StoneBlocks)
+  switch (type)
     {
-      loss = 12;
+    case Building::Wood:
+      return 4;
+    case Building::ConcreteWithWindows:
+      return 7;
+    case Building::ConcreteWithoutWindows:
+      return 15; // 10 ~ 20 dB
+    case Building::StoneBlocks:
+      return 12;
     }
-  return (loss);
+  return 0;
+}
+
+double
+BuildingsPropagationLossModel::ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const
+{
+  return GetExternalWallLoss (a->GetBuilding ()->GetExtWallsType ());
 }
 
 double
@@ -184,6 +183,18 @@ const
 
 
 
+void
+BuildingsPropagationLossModel::ClearShadowing (Ptr<MobilityModel> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  m_shadowingLossMap.erase (node);
+  for (std::map<Ptr<MobilityModel>,  std::map<Ptr<MobilityModel>, ShadowingLoss> >::iterator ait = m_shadowingLossMap.begin ();
+       ait != m_shadowingLossMap.end (); ++ait)
+    {
+      ait->second.erase (node);
+    }
+}
+
 double
 BuildingsPropagationLossModel::EvaluateSigma (Ptr<MobilityBuildingInfo> a, Ptr<MobilityBuildingInfo> b)
 const
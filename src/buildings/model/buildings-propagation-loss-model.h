@@ -71,6 +71,20 @@ public:
   // inherited from PropagationLossModel
   virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+  /**
+   * \param type the type of the external walls of a building
+   * \returns the loss of one crossing of the external walls, in dB
+   */
+  static double GetExternalWallLoss (Building::ExtWallsType_t type);
+
+  /**
+   * Forget the shadowing of the links from and to a node, so that it is
+   * drawn again the next time the loss of one of these links is computed.
+   *
+   * \param node the mobility model of the node
+   */
+  void ClearShadowing (Ptr<MobilityModel> node);
+
 protected:
   double ExternalWallLoss (Ptr<MobilityBuildingInfo> a) const;
   double HeightLoss (Ptr<MobilityBuildingInfo> n) const;
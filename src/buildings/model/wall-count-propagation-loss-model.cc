@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
+#include <ns3/building-list.h>
+#include "buildings-propagation-loss-model.h"
+#include "wall-count-propagation-loss-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WallCountPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (WallCountPropagationLossModel);
+
+TypeId
+WallCountPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WallCountPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Buildings")
+    .AddConstructor<WallCountPropagationLossModel> ()
+    .AddAttribute ("InternalWallLoss",
+                   "Additional loss for each internal wall [dB]",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&WallCountPropagationLossModel::m_lossInternalWall),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+WallCountPropagationLossModel::WallCountPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+double
+WallCountPropagationLossModel::GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  NS_LOG_FUNCTION (this << a << b);
+  Vector aPosition = a->GetPosition ();
+  Vector bPosition = b->GetPosition ();
+  BuildingList::GetBuildingsIntersecting (aPosition, bPosition, m_buildings);
+  double loss = 0;
+  for (std::vector<Ptr<Building> >::const_iterator it = m_buildings.begin (); it != m_buildings.end (); ++it)
+    {
+      uint32_t externalWalls = (*it)->GetNExternalWallsCrossed (aPosition, bPosition);
+      uint32_t internalWalls = (*it)->GetNInternalWallsCrossed (aPosition, bPosition);
+      NS_LOG_LOGIC ("building " << (*it)->GetId () << ": " << externalWalls << " external walls, "
+                                << internalWalls << " internal walls");
+      double externalWallLoss = BuildingsPropagationLossModel::GetExternalWallLoss ((*it)->GetExtWallsType ());
+      loss += externalWalls * externalWallLoss + internalWalls * m_lossInternalWall;
+    }
+  return loss;
+}
+
+double
+WallCountPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                              Ptr<MobilityModel> a,
+                                              Ptr<MobilityModel> b) const
+{
+  return txPowerDbm - GetLoss (a, b);
+}
+
+int64_t
+WallCountPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,75 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WALL_COUNT_PROPAGATION_LOSS_MODEL_H
+#define WALL_COUNT_PROPAGATION_LOSS_MODEL_H
+
+#include <vector>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/building.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup buildings
+ *
+ * \brief The penetration loss of the walls crossed by the direct path
+ *
+ * The loss is the sum, over the buildings which the segment between the
+ * two nodes intersects, of the external wall loss of the building for
+ * each crossing of its boundaries, and of InternalWallLoss for each wall
+ * between its rooms.  The external wall losses depend on the type of
+ * the external walls of the building, given by
+ * BuildingsPropagationLossModel::GetExternalWallLoss.
+ *
+ * The buildings are found with BuildingList::GetBuildingsIntersecting
+ * from the positions of the nodes, so unlike the other models of this
+ * module, the mobility models do not need a MobilityBuildingInfo and
+ * the nodes may move.  This model only computes the penetration loss: it
+ * is meant to be chained with PropagationLossModel::SetNext after a
+ * model of the path loss.
+ */
+class WallCountPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WallCountPropagationLossModel ();
+
+  /**
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the penetration loss, in dB
+   */
+  double GetLoss (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  double m_lossInternalWall;                     //!< loss of an internal wall, in dB
+  mutable std::vector<Ptr<Building> > m_buildings;  //!< buildings found by the last query
+};
+
+} // namespace ns3
+
+#endif /* WALL_COUNT_PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,245 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include <ns3/building.h>
+#include <ns3/building-list.h>
+#include <ns3/wall-count-propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/simulator.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BuildingIndexTest");
+
+/**
+ * \ingroup buildings
+ *
+ * Compare the buildings found with the index of BuildingList with the
+ * ones found by checking every building, for random buildings, positions
+ * and segments, before and after moving some buildings.
+ */
+class BuildingIndexTestCase : public TestCase
+{
+public:
+  BuildingIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check random positions and segments.
+   * \param uniform the random variable
+   * \param n the number of positions and of segments
+   */
+  void CheckQueries (Ptr<UniformRandomVariable> uniform, uint32_t n);
+  /**
+   * \param uniform the random variable
+   * \returns a random position around the buildings
+   */
+  Vector GetRandomPosition (Ptr<UniformRandomVariable> uniform) const;
+  /**
+   * \param uniform the random variable
+   * \returns a random building box
+   */
+  Box GetRandomBox (Ptr<UniformRandomVariable> uniform) const;
+};
+
+BuildingIndexTestCase::BuildingIndexTestCase ()
+  : TestCase ("Check the building queries of BuildingList")
+{
+}
+
+Vector
+BuildingIndexTestCase::GetRandomPosition (Ptr<UniformRandomVariable> uniform) const
+{
+  return Vector (uniform->GetValue (-100, 1100), uniform->GetValue (-100, 1100), uniform->GetValue (0, 40));
+}
+
+Box
+BuildingIndexTestCase::GetRandomBox (Ptr<UniformRandomVariable> uniform) const
+{
+  double x = uniform->GetValue (0, 1000);
+  double y = uniform->GetValue (0, 1000);
+  return Box (x, x + uniform->GetValue (5, 60), y, y + uniform->GetValue (5, 60), 0, uniform->GetValue (3, 30));
+}
+
+void
+BuildingIndexTestCase::CheckQueries (Ptr<UniformRandomVariable> uniform, uint32_t n)
+{
+  std::vector<Ptr<Building> > found;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Vector position = GetRandomPosition (uniform);
+      std::vector<Ptr<Building> > expected;
+      for (BuildingList::Iterator it = BuildingList::Begin (); it != BuildingList::End (); ++it)
+        {
+          if ((*it)->IsInside (position))
+            {
+              expected.push_back (*it);
+            }
+        }
+      BuildingList::GetBuildingsContaining (position, found);
+      NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong buildings containing " << position);
+
+      // long segments, short segments and vertical segments
+      Vector a = GetRandomPosition (uniform);
+      Vector b = GetRandomPosition (uniform);
+      if (i % 3 == 1)
+        {
+          b = Vector (a.x + uniform->GetValue (-50, 50), a.y + uniform->GetValue (-50, 50), b.z);
+        }
+      else if (i % 3 == 2)
+        {
+          b = Vector (a.x, a.y, b.z);
+        }
+      expected.clear ();
+      for (BuildingList::Iterator it = BuildingList::Begin (); it != BuildingList::End (); ++it)
+        {
+          if ((*it)->IsIntersect (a, b))
+            {
+              expected.push_back (*it);
+            }
+        }
+      BuildingList::GetBuildingsIntersecting (a, b, found);
+      NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong buildings intersecting " << a << " - " << b);
+    }
+}
+
+void
+BuildingIndexTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+
+  for (uint32_t i = 0; i < 500; ++i)
+    {
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (GetRandomBox (uniform));
+    }
+  CheckQueries (uniform, 1000);
+
+  // the index is updated when buildings are moved or added
+  for (uint32_t i = 0; i < 500; i += 10)
+    {
+      BuildingList::GetBuilding (i)->SetBoundaries (GetRandomBox (uniform));
+    }
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (2000, 2100, 2000, 2100, 0, 10));
+  CheckQueries (uniform, 1000);
+  std::vector<Ptr<Building> > found;
+  BuildingList::GetBuildingsContaining (Vector (2050, 2050, 5), found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "The new building was not found");
+  NS_TEST_ASSERT_MSG_EQ (found[0], building, "Wrong building found");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup buildings
+ *
+ * Check the walls counted by Building and the loss of
+ * WallCountPropagationLossModel for a building with 3x2 rooms.
+ */
+class WallCountTestCase : public TestCase
+{
+public:
+  WallCountTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WallCountTestCase::WallCountTestCase ()
+  : TestCase ("Check the walls crossed by a segment")
+{
+}
+
+void
+WallCountTestCase::DoRun (void)
+{
+  Ptr<Building> building = CreateObject<Building> ();
+  building->SetBoundaries (Box (0, 30, 0, 20, 0, 10));
+  building->SetNRoomsX (3);
+  building->SetNRoomsY (2);
+  building->SetExtWallsType (Building::ConcreteWithWindows);
+  Ptr<Building> other = CreateObject<Building> ();
+  other->SetBoundaries (Box (100, 110, 0, 10, 0, 10));
+  other->SetExtWallsType (Building::Wood);
+
+  struct
+  {
+    Vector a;
+    Vector b;
+    uint32_t externalWalls;
+    uint32_t internalWalls;
+    double lossDb;
+  } segments[] = {
+    // through the building along x, then through the other building
+    { Vector (-10, 5, 5), Vector (40, 5, 5), 2, 2, 24 },
+    { Vector (-10, 5, 5), Vector (120, 5, 5), 2, 2, 32 },
+    // from a room to the outside along y
+    { Vector (5, 5, 5), Vector (5, 30, 5), 1, 1, 12 },
+    // between two rooms
+    { Vector (5, 5, 5), Vector (25, 15, 5), 0, 3, 15 },
+    // within a room
+    { Vector (1, 1, 1), Vector (9, 9, 9), 0, 0, 0 },
+    // above the building
+    { Vector (-10, 5, 20), Vector (40, 5, 20), 0, 0, 0 },
+    // next to the building
+    { Vector (-10, -5, 5), Vector (40, -5, 5), 0, 0, 0 },
+    // through the roof
+    { Vector (5, 5, 5), Vector (5, 5, 20), 1, 0, 7 },
+  };
+
+  Ptr<WallCountPropagationLossModel> loss = CreateObject<WallCountPropagationLossModel> ();
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  for (uint32_t i = 0; i < sizeof (segments) / sizeof (segments[0]); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (building->GetNExternalWallsCrossed (segments[i].a, segments[i].b), segments[i].externalWalls,
+                             "Wrong number of external walls for segment " << i);
+      NS_TEST_EXPECT_MSG_EQ (building->GetNInternalWallsCrossed (segments[i].a, segments[i].b), segments[i].internalWalls,
+                             "Wrong number of internal walls for segment " << i);
+      a->SetPosition (segments[i].a);
+      b->SetPosition (segments[i].b);
+      NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (0, a, b), -segments[i].lossDb, 1e-9, "Wrong loss for segment " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (loss->CalcRxPower (0, b, a), -segments[i].lossDb, 1e-9, "Wrong loss for reversed segment " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup buildings
+ *
+ * Building index test suite
+ */
+class BuildingIndexTestSuite : public TestSuite
+{
+public:
+  BuildingIndexTestSuite ();
+};
+
+BuildingIndexTestSuite::BuildingIndexTestSuite ()
+  : TestSuite ("building-index", UNIT)
+{
+  AddTestCase (new BuildingIndexTestCase, TestCase::QUICK);
+  AddTestCase (new WallCountTestCase, TestCase::QUICK);
+}
+
+static BuildingIndexTestSuite g_buildingIndexTestSuite;
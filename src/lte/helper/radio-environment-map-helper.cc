@@ -36,10 +36,27 @@
 #include <ns3/simulator.h>
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
+#include <ns3/building-list.h>
+#include <ns3/buildings-propagation-loss-model.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/node-list.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/component-carrier-enb.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
 
 namespace ns3 {
 
@@ -48,6 +65,9 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (std::numeric_limits<double>::infinity ()),
+    m_makeConsistent (true),
+    m_blockStart (0)
 {
 }
 
@@ -144,6 +164,21 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectComputation",
+                   "If true, the REM is computed by Install () from the propagation models "
+                   "of the channel, without RemSpectrumPhy instances nor simulation events. "
+                   "Only the control channel is supported.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directComputation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumberOfThreads",
+                   "The number of threads of the direct computation. A single thread is used if "
+                   "there are buildings, a SpectrumPropagationLossModel, or a propagation loss "
+                   "model of the channel which is not thread safe (see PropagationLossModel::IsThreadSafe). "
+                   "The antenna models are called concurrently, so they must not modify any state.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_nThreads),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -200,6 +235,12 @@ RadioEnvironmentMapHelper::Install ()
       return;
     }
   
+  if (m_directComputation)
+    {
+      ComputeDirect ();
+      return;
+    }
+
   double startDelay = 0.0026;
 
   if (m_useDataChannel)
@@ -347,7 +388,276 @@ RadioEnvironmentMapHelper::Finalize ()
   m_outFile.close ();
   if (m_stopWhenDone)
     {
-      Simulator::Stop ();
+      if (m_directComputation)
+        {
+          // the simulation may not be running yet
+          Simulator::Stop (Seconds (0));
+        }
+      else
+        {
+          Simulator::Stop ();
+        }
+    }
+}
+
+void
+RadioEnvironmentMapHelper::ComputeDirect ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_useDataChannel, "the direct computation of the REM only supports the control channel");
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  m_spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb;
+  if (m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb))
+    {
+      m_maxLossDb = maxLossDb.Get ();
+    }
+  // the buildings models cache the shadowing of each pair of mobility
+  // models, which must be drawn again for each point
+  m_buildingsPropagationLoss.clear ();
+  bool threadSafe = true;
+  for (Ptr<PropagationLossModel> model = m_propagationLoss; model != 0; model = model->GetNext ())
+    {
+      threadSafe = threadSafe && model->IsThreadSafe ();
+      Ptr<BuildingsPropagationLossModel> buildingsModel = model->GetObject<BuildingsPropagationLossModel> ();
+      if (buildingsModel != 0)
+        {
+          m_buildingsPropagationLoss.push_back (buildingsModel);
+        }
+    }
+  bool buildings = BuildingList::GetNBuildings () > 0;
+
+  // the eNBs transmitting their control frames on the channel, with the
+  // full bandwidth
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  m_transmitters.clear ();
+  for (NodeList::Iterator nit = NodeList::Begin (); nit != NodeList::End (); ++nit)
+    {
+      for (uint32_t i = 0; i < (*nit)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = (*nit)->GetDevice (i)->GetObject<LteEnbNetDevice> ();
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          std::map<uint8_t, Ptr<ComponentCarrierEnb> > ccMap = enbDev->GetCcMap ();
+          for (std::map<uint8_t, Ptr<ComponentCarrierEnb> >::iterator ccIt = ccMap.begin (); ccIt != ccMap.end (); ++ccIt)
+            {
+              Ptr<LteEnbPhy> phy = ccIt->second->GetPhy ();
+              Ptr<LteSpectrumPhy> dlPhy = phy->GetDownlinkSpectrumPhy ();
+              if (dlPhy->GetChannel () != m_channel)
+                {
+                  continue;
+                }
+              std::vector<int> rbs;
+              for (uint8_t rb = 0; rb < ccIt->second->GetDlBandwidth (); ++rb)
+                {
+                  rbs.push_back (rb);
+                }
+              Ptr<SpectrumValue> psd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (ccIt->second->GetDlEarfcn (),
+                                                                                              ccIt->second->GetDlBandwidth (),
+                                                                                              phy->GetTxPower (), rbs);
+              if (psd->GetSpectrumModelUid () != rxSpectrumModel->GetUid ())
+                {
+                  if (psd->GetSpectrumModel ()->IsOrthogonal (*rxSpectrumModel))
+                    {
+                      continue;
+                    }
+                  psd = SpectrumConverter::GetConverter (psd->GetSpectrumModel (), rxSpectrumModel)->Convert (psd);
+                }
+              RemTransmitter transmitter;
+              transmitter.mobility = dlPhy->GetMobility ();
+              transmitter.antenna = dlPhy->GetRxAntenna ();
+              transmitter.psd = psd;
+              transmitter.power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+              if (transmitter.mobility != 0 && transmitter.mobility->GetObject<MobilityBuildingInfo> () != 0)
+                {
+                  BuildingsHelper::MakeConsistent (transmitter.mobility);
+                }
+              m_transmitters.push_back (transmitter);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("REM of " << m_transmitters.size () << " transmitters");
+
+  uint32_t nThreads = m_nThreads;
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+  // the building list is shared by BuildingsHelper::MakeConsistent and the
+  // building aware models, the spectrum models copy pointers to shared
+  // objects, and the other models may draw random variables or update
+  // caches unless they declare themselves thread safe
+  if (nThreads > 1 && (buildings || !threadSafe || m_spectrumPropagationLoss != 0))
+    {
+      NS_LOG_WARN ("the propagation loss models cannot be called concurrently, using a single thread");
+      nThreads = 1;
+    }
+  // without buildings, every point is outdoor, which is the initial state
+  // of MobilityBuildingInfo, so the threads need not call MakeConsistent
+  m_makeConsistent = (nThreads == 1);
+
+  // with several threads, each thread has its own copies of the mobility
+  // models of the transmitters, so that the threads do not share any
+  // reference counted object but the models.  As in DelayedInstall, all
+  // the mobility models have a MobilityBuildingInfo.
+  const uint32_t batchSize = 64;
+  std::vector<RemWorker> workers (nThreads);
+  for (uint32_t w = 0; w < nThreads; ++w)
+    {
+      for (uint32_t t = 0; t < m_transmitters.size (); ++t)
+        {
+          Ptr<MobilityModel> mobility = m_transmitters[t].mobility;
+          if (nThreads > 1 && mobility != 0)
+            {
+              Ptr<MobilityModel> copy = CreateObject<ConstantPositionMobilityModel> ();
+              copy->SetPosition (mobility->GetPosition ());
+              copy->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+              BuildingsHelper::MakeConsistent (copy);
+              mobility = copy;
+            }
+          workers[w].txMobilities.push_back (mobility);
+        }
+      for (uint32_t i = 0; i < batchSize; ++i)
+        {
+          Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+          workers[w].rxMobilities.push_back (mobility);
+        }
+    }
+
+  // compute and write the map by blocks, to bound the memory; the values
+  // are written with all their digits, so that the maps computed with
+  // different numbers of threads can be compared exactly
+  m_outFile.precision (std::numeric_limits<double>::max_digits10);
+  uint64_t nPoints = static_cast<uint64_t> (m_xRes) * m_yRes;
+  for (m_blockStart = 0; m_blockStart < nPoints; m_blockStart += m_maxPointsPerIteration)
+    {
+      uint64_t blockEnd = std::min (nPoints, m_blockStart + m_maxPointsPerIteration);
+      uint64_t blockSize = blockEnd - m_blockStart;
+      m_sinr.resize (blockSize);
+      for (uint32_t w = 0; w < nThreads; ++w)
+        {
+          workers[w].first = m_blockStart + blockSize * w / nThreads;
+          workers[w].last = m_blockStart + blockSize * (w + 1) / nThreads;
+        }
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t w = 1; w < nThreads; ++w)
+        {
+          Callback<void, RemWorker *> cb = MakeCallback (&RadioEnvironmentMapHelper::ComputePoints, this);
+          threads.push_back (Create<SystemThread> (cb.Bind (&workers[w])));
+          threads.back ()->Start ();
+        }
+#endif
+      ComputePoints (&workers[0]);
+#ifdef HAVE_PTHREAD_H
+      for (uint32_t i = 0; i < threads.size (); ++i)
+        {
+          threads[i]->Join ();
+        }
+#endif
+      for (uint64_t k = m_blockStart; k < blockEnd; ++k)
+        {
+          m_outFile << m_xMin + (k / m_yRes) * m_xStep << "\t"
+                    << m_yMin + (k % m_yRes) * m_yStep << "\t"
+                    << m_z << "\t"
+                    << m_sinr[k - m_blockStart]
+                    << "\n";
+        }
+      m_outFile.flush ();
+    }
+  m_sinr.clear ();
+  m_transmitters.clear ();
+  m_buildingsPropagationLoss.clear ();
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputePoints (RemWorker *worker)
+{
+  std::vector<Ptr<MobilityModel> > rxMobilities;
+  std::vector<double> propagationGainsDb;
+  std::vector<double> sumPower;
+  std::vector<double> referenceSignalPower;
+  for (uint64_t first = worker->first; first < worker->last; first += worker->rxMobilities.size ())
+    {
+      uint64_t n = std::min<uint64_t> (worker->rxMobilities.size (), worker->last - first);
+      rxMobilities.assign (worker->rxMobilities.begin (), worker->rxMobilities.begin () + n);
+      for (uint64_t j = 0; j < n; ++j)
+        {
+          uint64_t k = first + j;
+          rxMobilities[j]->SetPosition (Vector (m_xMin + (k / m_yRes) * m_xStep,
+                                                m_yMin + (k % m_yRes) * m_yStep,
+                                                m_z));
+          if (m_makeConsistent)
+            {
+              BuildingsHelper::MakeConsistent (rxMobilities[j]);
+            }
+        }
+      sumPower.assign (n, 0);
+      referenceSignalPower.assign (n, 0);
+
+      for (uint32_t t = 0; t < m_transmitters.size (); ++t)
+        {
+          const RemTransmitter &transmitter = m_transmitters[t];
+          Ptr<MobilityModel> txMobility = worker->txMobilities[t];
+          if (txMobility != 0 && m_propagationLoss != 0)
+            {
+              m_propagationLoss->CalcRxPowerBatch (0, txMobility, rxMobilities, propagationGainsDb);
+            }
+          for (uint64_t j = 0; j < n; ++j)
+            {
+              double power = transmitter.power;
+              if (txMobility != 0)
+                {
+                  // same computation as the spectrum channels
+                  double pathLossDb = 0;
+                  if (transmitter.antenna != 0)
+                    {
+                      Angles txAngles (rxMobilities[j]->GetPosition (), txMobility->GetPosition ());
+                      pathLossDb -= transmitter.antenna->GetGainDb (txAngles);
+                    }
+                  if (m_propagationLoss != 0)
+                    {
+                      pathLossDb -= propagationGainsDb[j];
+                    }
+                  if (pathLossDb > m_maxLossDb)
+                    {
+                      continue;
+                    }
+                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                  if (m_spectrumPropagationLoss != 0)
+                    {
+                      Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (transmitter.psd);
+                      *rxPsd *= pathGainLinear;
+                      rxPsd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxPsd, txMobility, rxMobilities[j]);
+                      power = (m_rbId >= 0) ? (*rxPsd)[m_rbId] * 180000 : Integral (*rxPsd);
+                    }
+                  else
+                    {
+                      power *= pathGainLinear;
+                    }
+                }
+              sumPower[j] += power;
+              if (power > referenceSignalPower[j])
+                {
+                  referenceSignalPower[j] = power;
+                }
+            }
+        }
+
+      for (uint64_t j = 0; j < n; ++j)
+        {
+          m_sinr[first + j - m_blockStart] = referenceSignalPower[j] / (sumPower[j] - referenceSignalPower[j] + m_noisePower);
+          // the mobility models are reused by the next batch, at other points
+          for (uint32_t b = 0; b < m_buildingsPropagationLoss.size (); ++b)
+            {
+              m_buildingsPropagationLoss[b]->ClearShadowing (rxMobilities[j]);
+            }
+        }
     }
 }
 
@@ -25,6 +25,7 @@
 
 #include <ns3/object.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +36,11 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SpectrumValue;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+class BuildingsPropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -42,6 +48,16 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is measured by RemSpectrumPhy instances attached to
+ * the channel, while the simulation runs.  If the DirectComputation
+ * attribute is true, the map is instead computed when Install() is
+ * called, by evaluating the propagation models of the channel between
+ * each eNB and each point of the map, without creating any phy nor
+ * scheduling any event.  The points are computed by blocks of
+ * MaxPointsPerIteration points, which are written to the file before the
+ * next block is computed, and the points of a block are shared by
+ * NumberOfThreads threads.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -70,7 +86,8 @@ public:
   void SetBandwidth (uint8_t bw);
 
   /** 
-   * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings.
+   * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings,
+   * or compute and write the map if the DirectComputation attribute is true.
    * 
    */
   void Install ();
@@ -108,6 +125,45 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /// A transmitter of the direct computation of the map.
+  struct RemTransmitter
+  {
+    /// Mobility model of the transmitter.
+    Ptr<MobilityModel> mobility;
+    /// Antenna of the transmitter, or 0.
+    Ptr<AntennaModel> antenna;
+    /// Transmitted PSD, in the spectrum model of the map.
+    Ptr<SpectrumValue> psd;
+    /// Transmitted power measured by the map, in W.
+    double power;
+  };
+
+  /// The points of the map computed by a thread.
+  struct RemWorker
+  {
+    /// Index of the first point.
+    uint64_t first;
+    /// Index following the last point.
+    uint64_t last;
+    /// Mobility models of the transmitters used by the thread.
+    std::vector<Ptr<MobilityModel> > txMobilities;
+    /// Mobility models of a batch of points.
+    std::vector<Ptr<MobilityModel> > rxMobilities;
+  };
+
+  /**
+   * Compute the whole map from the propagation models of the channel,
+   * write it and call Finalize().
+   */
+  void ComputeDirect ();
+
+  /**
+   * Compute the SINR of the points of a worker, in m_sinr.
+   *
+   * \param worker the worker
+   */
+  void ComputePoints (RemWorker *worker);
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +208,26 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_directComputation;  ///< The `DirectComputation` attribute.
+  uint32_t m_nThreads;       ///< The `NumberOfThreads` attribute.
+
+  /// Transmitters of the direct computation.
+  std::vector<RemTransmitter> m_transmitters;
+  /// Single-frequency propagation loss model of the channel.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// Frequency-dependent propagation loss model of the channel.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  /// Buildings models of the chain of propagation loss models.
+  std::vector<Ptr<BuildingsPropagationLossModel> > m_buildingsPropagationLoss;
+  /// The `MaxLossDb` attribute of the channel.
+  double m_maxLossDb;
+  /// Whether the positions of the points must be checked against the buildings.
+  bool m_makeConsistent;
+  /// Index of the first point of the block being computed.
+  uint64_t m_blockStart;
+  /// SINR of the points of the block being computed.
+  std::vector<double> m_sinr;
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
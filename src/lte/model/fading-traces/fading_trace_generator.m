@@ -129,3 +129,17 @@ end
 
 fclose(file);
 
+
+% binary file, mapped in memory by TraceFadingLossModel (see
+% FadingTrace in the propagation module): 24 bytes header, then the
+% gains in dB, RB after RB, as doubles in the byte order of the host
+bin = fopen(strcat('fading_trace_',tag,'.bin'),'w');
+fwrite(bin, hex2dec('6e733366'), 'uint32');
+fwrite(bin, 1, 'uint16');
+fwrite(bin, 0, 'uint16');
+fwrite(bin, numRBs, 'uint32');
+fwrite(bin, len, 'uint32');
+fwrite(bin, TTI, 'double');
+% fwrite writes column after column, so transpose to write RB after RB
+fwrite(bin, (10.*log10(ppssdd(1:numRBs, 1:len)))', 'double');
+fclose(bin);
@@ -53,6 +53,7 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_background = 0;
   Object::DoDispose ();
 } 
 
@@ -188,7 +189,13 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      SpectrumValue interf = *m_allSignals;
+      interf -= *m_rxSignal;
+      interf += *m_noise;
+      if (m_background)
+        {
+          interf += *m_background;
+        }
 
       SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
@@ -214,6 +221,7 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   NS_LOG_FUNCTION (this << *noisePsd);
   ConditionallyEvaluateChunk ();
   m_noise = noisePsd;
+  m_background = 0;
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
@@ -227,6 +235,20 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   m_lastSignalIdBeforeReset = m_lastSignalId;
 }
 
+void
+LteInterference::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  NS_LOG_FUNCTION (this << backgroundPsd);
+  ConditionallyEvaluateChunk ();
+  if (backgroundPsd && m_noise && backgroundPsd->GetSpectrumModelUid () != m_noise->GetSpectrumModelUid ())
+    {
+      // left from a previous spectrum model
+      NS_LOG_LOGIC ("ignoring background of a different spectrum model");
+      return;
+    }
+  m_background = backgroundPsd;
+}
+
 void
 LteInterference::AddRsPowerChunkProcessor (Ptr<LteChunkProcessor> p)
 {
@@ -117,6 +117,17 @@ public:
    */
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
+  /**
+   * Set the power spectral density of the background interference, i.e.,
+   * the signals which the channel aggregated instead of delivering them
+   * individually.  It is added to the noise until it is set again, and is
+   * cleared by SetNoisePowerSpectralDensity.
+   *
+   * @param backgroundPsd the background Power Spectral Density in power
+   * units per Hz, or 0 for none
+   */
+  void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+
 private:
   /**
    * Considitionally evaluate chunk
@@ -152,6 +163,8 @@ private:
 
   Ptr<const SpectrumValue> m_noise; ///< the noise value
 
+  Ptr<const SpectrumValue> m_background; ///< the background interference, if any
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
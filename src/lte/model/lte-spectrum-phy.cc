@@ -331,6 +331,20 @@ LteSpectrumPhy::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
   m_interferenceCtrl->SetNoisePowerSpectralDensity (noisePsd);
 }
 
+void
+LteSpectrumPhy::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  NS_LOG_FUNCTION (this << backgroundPsd);
+  m_interferenceData->SetBackgroundPowerSpectralDensity (backgroundPsd);
+  m_interferenceCtrl->SetBackgroundPowerSpectralDensity (backgroundPsd);
+}
+
+bool
+LteSpectrumPhy::SupportsBackgroundInterference (void) const
+{
+  return true;
+}
+
   
 void 
 LteSpectrumPhy::Reset ()
@@ -191,6 +191,8 @@ public:
   Ptr<const SpectrumModel> GetRxSpectrumModel () const;
   Ptr<AntennaModel> GetRxAntenna ();
   void StartRx (Ptr<SpectrumSignalParameters> params);
+  void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+  bool SupportsBackgroundInterference (void) const;
   /**
    * \brief Start receive data function
    * \param params Ptr<LteSpectrumSignalParametersDataFrame>
@@ -24,10 +24,10 @@
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/log.h>
+#include <ns3/abort.h>
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
-#include <fstream>
 #include <ns3/simulator.h>
 
 namespace ns3 {
@@ -48,7 +48,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -82,7 +82,8 @@ TraceFadingLossModel::GetTypeId (void)
                   MakeTimeAccessor (&TraceFadingLossModel::m_windowSize),
                   MakeTimeChecker ())
     .AddAttribute ("RbNum",
-                    "The number of RB the trace is made of (default 100)",
+                    "The number of RB the trace is made of (default 100).  A binary "
+                    "trace stores its number of RBs, which overrides this value.",
                     UintegerValue (100),
                    MakeUintegerAccessor (&TraceFadingLossModel::m_rbNum),
                    MakeUintegerChecker<uint8_t> ())
@@ -120,28 +121,24 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
+  m_fadingTrace = FadingTrace::Load (m_traceFile);
+  if (m_fadingTrace != 0)
     {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
+      // the dimensions of a binary trace override the attributes
+      NS_ABORT_MSG_IF (m_fadingTrace->GetNRows () > 100, "The fading trace has more than 100 RBs");
+      m_rbNum = m_fadingTrace->GetNRows ();
+      m_samplesNum = m_fadingTrace->GetNSamples ();
+      m_traceLength = m_fadingTrace->GetSamplePeriod () * m_samplesNum;
+    }
+  else
+    {
+      m_fadingTrace = FadingTrace::LoadText (m_traceFile, m_rbNum, m_samplesNum,
+                                             MilliSeconds (m_traceLength.GetMilliSeconds () / m_samplesNum));
+      NS_ABORT_MSG_IF (m_fadingTrace == 0, "Unable to load the fading trace " << m_traceFile);
     }
 
 //   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
 //   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
-    {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
-    }
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
@@ -201,7 +198,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
@@ -211,7 +208,8 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          NS_ABORT_MSG_IF (subChannel >= m_rbNum, "The fading trace has only " << (uint32_t) m_rbNum << " RBs");
+          double fading = m_fadingTrace->Get (subChannel, index);
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -29,6 +29,7 @@
 #include <map>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
+#include <ns3/fading-trace.h>
 
 namespace ns3 {
 
@@ -40,6 +41,13 @@ class MobilityModel;
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace file is either a text file, holding RbNum lines of SamplesNum
+ * gains in dB, or a binary FadingTrace file (see the
+ * utils/convert-fading-trace program), whose dimensions and length
+ * override the RbNum, SamplesNum and TraceLength attributes.  A binary
+ * file is mapped in memory rather than parsed, and each file is loaded
+ * once and shared by all the models which use it.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -112,20 +120,9 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  Ptr<const FadingTrace> m_fadingTrace; ///< fading trace, one row per RB
 
   
   Time m_traceLength; ///< the trace time
@@ -0,0 +1,321 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/test.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/radio-environment-map-helper.h"
+#include "ns3/building.h"
+#include "ns3/buildings-helper.h"
+#include "ns3/building-list.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRadioEnvironmentMapTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Compare the radio environment maps computed by the
+ * RemSpectrumPhy instances and by the direct computation, with a
+ * HybridBuildingsPropagationLossModel without shadowing, with or
+ * without a building in the map.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param buildings whether to add a building in the map
+   */
+  LteRadioEnvironmentMapTestCase (bool buildings);
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A point of a map.
+  struct Point
+  {
+    double x;     ///< x coordinate
+    double y;     ///< y coordinate
+    double z;     ///< z coordinate
+    double sinr;  ///< SINR
+  };
+
+  /**
+   * Read a map
+   * \param filename the name of the file of the map
+   * \returns the points of the map
+   */
+  static std::vector<Point> ReadMap (std::string filename);
+
+  /**
+   * Create a radio environment map helper for the test grid
+   * \param channelPath the path of the channel
+   * \param filename the name of the output file
+   * \param direct whether to use the direct computation
+   * \returns the helper
+   */
+  static Ptr<RadioEnvironmentMapHelper> CreateRem (std::string channelPath, std::string filename, bool direct);
+
+  bool m_buildings; ///< whether to add a building in the map
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (bool buildings)
+  : TestCase (buildings ? "Direct and event-driven maps with a building" : "Direct and event-driven maps without buildings"),
+    m_buildings (buildings)
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+std::vector<LteRadioEnvironmentMapTestCase::Point>
+LteRadioEnvironmentMapTestCase::ReadMap (std::string filename)
+{
+  std::vector<Point> points;
+  std::ifstream file (filename.c_str ());
+  Point p;
+  while (file >> p.x >> p.y >> p.z >> p.sinr)
+    {
+      points.push_back (p);
+    }
+  return points;
+}
+
+Ptr<RadioEnvironmentMapHelper>
+LteRadioEnvironmentMapTestCase::CreateRem (std::string channelPath, std::string filename, bool direct)
+{
+  Ptr<RadioEnvironmentMapHelper> rem = CreateObject<RadioEnvironmentMapHelper> ();
+  rem->SetAttribute ("ChannelPath", StringValue (channelPath));
+  rem->SetAttribute ("OutputFile", StringValue (filename));
+  rem->SetAttribute ("XMin", DoubleValue (-50.0));
+  rem->SetAttribute ("XMax", DoubleValue (250.0));
+  rem->SetAttribute ("YMin", DoubleValue (-50.0));
+  rem->SetAttribute ("YMax", DoubleValue (150.0));
+  rem->SetAttribute ("XRes", UintegerValue (31));
+  rem->SetAttribute ("YRes", UintegerValue (21));
+  rem->SetAttribute ("Z", DoubleValue (1.5));
+  // several blocks, and more points than a batch of the direct computation
+  rem->SetAttribute ("MaxPointsPerIteration", UintegerValue (200));
+  rem->SetAttribute ("DirectComputation", BooleanValue (direct));
+  // the direct computation must not stop the event-driven one
+  rem->SetAttribute ("StopWhenDone", BooleanValue (!direct));
+  return rem;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  Config::Reset ();
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::HybridBuildingsPropagationLossModel"));
+  lteHelper->SetPathlossModelAttribute ("ShadowSigmaOutdoor", DoubleValue (0.0));
+  lteHelper->SetPathlossModelAttribute ("ShadowSigmaIndoor", DoubleValue (0.0));
+  lteHelper->SetPathlossModelAttribute ("ShadowSigmaExtWalls", DoubleValue (0.0));
+
+  if (m_buildings)
+    {
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (40.0, 90.0, 20.0, 60.0, 0.0, 9.0));
+      building->SetExtWallsType (Building::ConcreteWithWindows);
+      building->SetNFloors (3);
+      building->SetNRoomsX (2);
+      building->SetNRoomsY (2);
+    }
+
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (200.0, 100.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  BuildingsHelper::Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << lteHelper->GetDownlinkSpectrumChannel ()->GetId ();
+  std::string directFilename = CreateTempDirFilename ("rem-direct.out");
+  std::string eventFilename = CreateTempDirFilename ("rem-event.out");
+  Ptr<RadioEnvironmentMapHelper> direct = CreateRem (channelPath.str (), directFilename, true);
+  direct->Install ();
+  Ptr<RadioEnvironmentMapHelper> event = CreateRem (channelPath.str (), eventFilename, false);
+  event->Install ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<Point> directPoints = ReadMap (directFilename);
+  std::vector<Point> eventPoints = ReadMap (eventFilename);
+  NS_TEST_ASSERT_MSG_EQ (directPoints.size (), 31 * 21, "Wrong number of points of the direct map");
+  NS_TEST_ASSERT_MSG_EQ (eventPoints.size (), directPoints.size (), "Wrong number of points of the event-driven map");
+  for (uint32_t i = 0; i < directPoints.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (directPoints[i].x, eventPoints[i].x, 1e-3, "Wrong x of point " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (directPoints[i].y, eventPoints[i].y, 1e-3, "Wrong y of point " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (directPoints[i].z, eventPoints[i].z, 1e-3, "Wrong z of point " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (directPoints[i].sinr, eventPoints[i].sinr, eventPoints[i].sinr * 1e-4,
+                                 "Wrong SINR of point " << i);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Compare the radio environment maps computed directly by one and
+ * by several threads, with the default FriisPropagationLossModel of the
+ * LteHelper.  The maps must be identical.
+ */
+class LteRadioEnvironmentMapThreadsTestCase : public TestCase
+{
+public:
+  LteRadioEnvironmentMapThreadsTestCase ();
+  virtual ~LteRadioEnvironmentMapThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Read the lines of a map
+   * \param filename the name of the file of the map
+   * \returns the lines of the map
+   */
+  static std::vector<std::string> ReadLines (std::string filename);
+};
+
+LteRadioEnvironmentMapThreadsTestCase::LteRadioEnvironmentMapThreadsTestCase ()
+  : TestCase ("Direct maps computed by one and by several threads")
+{
+}
+
+LteRadioEnvironmentMapThreadsTestCase::~LteRadioEnvironmentMapThreadsTestCase ()
+{
+}
+
+std::vector<std::string>
+LteRadioEnvironmentMapThreadsTestCase::ReadLines (std::string filename)
+{
+  std::vector<std::string> lines;
+  std::ifstream file (filename.c_str ());
+  std::string line;
+  while (std::getline (file, line))
+    {
+      lines.push_back (line);
+    }
+  return lines;
+}
+
+void
+LteRadioEnvironmentMapThreadsTestCase::DoRun (void)
+{
+  Config::Reset ();
+  // a building would force a single thread
+  NS_TEST_ASSERT_MSG_EQ (BuildingList::GetNBuildings (), 0, "The test must run before the cases with buildings");
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (200.0, 100.0, 30.0));
+  positionAlloc->Add (Vector (150.0, -20.0, 25.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << lteHelper->GetDownlinkSpectrumChannel ()->GetId ();
+  std::vector<std::string> maps[2];
+  uint32_t nThreads[2] = {1, 4};
+  for (uint32_t m = 0; m < 2; ++m)
+    {
+      std::ostringstream filename;
+      filename << "rem-threads-" << nThreads[m] << ".out";
+      std::string path = CreateTempDirFilename (filename.str ());
+      Ptr<RadioEnvironmentMapHelper> rem = CreateObject<RadioEnvironmentMapHelper> ();
+      rem->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+      rem->SetAttribute ("OutputFile", StringValue (path));
+      rem->SetAttribute ("XMin", DoubleValue (-50.0));
+      rem->SetAttribute ("XMax", DoubleValue (250.0));
+      rem->SetAttribute ("YMin", DoubleValue (-50.0));
+      rem->SetAttribute ("YMax", DoubleValue (150.0));
+      rem->SetAttribute ("XRes", UintegerValue (41));
+      rem->SetAttribute ("YRes", UintegerValue (31));
+      rem->SetAttribute ("Z", DoubleValue (1.5));
+      // several blocks, each of which is shared by the threads in more
+      // than one batch
+      rem->SetAttribute ("MaxPointsPerIteration", UintegerValue (300));
+      rem->SetAttribute ("DirectComputation", BooleanValue (true));
+      rem->SetAttribute ("StopWhenDone", BooleanValue (false));
+      rem->SetAttribute ("NumberOfThreads", UintegerValue (nThreads[m]));
+      rem->Install ();
+      maps[m] = ReadLines (path);
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (maps[0].size (), 41 * 31, "Wrong number of points of the map computed by one thread");
+  NS_TEST_ASSERT_MSG_EQ (maps[1].size (), maps[0].size (), "Wrong number of points of the map computed by several threads");
+  for (uint32_t i = 0; i < maps[0].size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (maps[1][i], maps[0][i], "Wrong point " << i << " of the map computed by several threads");
+    }
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Radio environment map test suite
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  // the buildings stay in BuildingList, so the cases without buildings go first
+  AddTestCase (new LteRadioEnvironmentMapTestCase (false), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapThreadsTestCase, TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (true), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
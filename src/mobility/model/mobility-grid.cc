@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "mobility-grid.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityGrid");
+
+MobilityGrid::MobilityGrid (double cellSize, Time refreshPeriod)
+  : m_cellSize (cellSize),
+    m_refreshPeriod (refreshPeriod),
+    m_lastRefresh (Simulator::Now ()),
+    m_maxSpeed (0)
+{
+  NS_LOG_FUNCTION (this << cellSize << refreshPeriod);
+  NS_ASSERT_MSG (cellSize > 0, "The cell size must be positive");
+}
+
+MobilityGrid::~MobilityGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+MobilityGrid::Add (Ptr<MobilityModel> mobility, uint32_t id)
+{
+  NS_LOG_FUNCTION (this << mobility << id);
+  Entry entry;
+  entry.mobility = mobility;
+  entry.id = id;
+  entry.cell = GetCell (mobility->GetPosition ());
+  entry.speed = CalculateDistance (mobility->GetVelocity (), Vector ());
+  uint32_t slot = m_entries.size ();
+  m_entries.push_back (entry);
+  m_cells[entry.cell].push_back (slot);
+  m_maxSpeed = std::max (m_maxSpeed, entry.speed);
+  std::vector<uint32_t> &slots = m_slots[PeekPointer (mobility)];
+  if (slots.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MobilityGrid::NotifyCourseChange, this));
+    }
+  slots.push_back (slot);
+}
+
+void
+MobilityGrid::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_slots.begin (); i != m_slots.end (); ++i)
+    {
+      m_entries[i->second.front ()].mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MobilityGrid::NotifyCourseChange, this));
+    }
+  m_entries.clear ();
+  m_cells.clear ();
+  m_slots.clear ();
+  m_maxSpeed = 0;
+}
+
+uint32_t
+MobilityGrid::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+MobilityGrid::Cell
+MobilityGrid::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int32_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int32_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+MobilityGrid::Update (uint32_t slot)
+{
+  Entry &entry = m_entries[slot];
+  Cell cell = GetCell (entry.mobility->GetPosition ());
+  entry.speed = CalculateDistance (entry.mobility->GetVelocity (), Vector ());
+  if (cell == entry.cell)
+    {
+      return;
+    }
+  std::vector<uint32_t> &old = m_cells[entry.cell];
+  std::vector<uint32_t>::iterator i = std::find (old.begin (), old.end (), slot);
+  NS_ASSERT (i != old.end ());
+  *i = old.back ();
+  old.pop_back ();
+  if (old.empty ())
+    {
+      m_cells.erase (entry.cell);
+    }
+  entry.cell = cell;
+  m_cells[cell].push_back (slot);
+}
+
+void
+MobilityGrid::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_maxSpeed = 0;
+  for (uint32_t slot = 0; slot < m_entries.size (); ++slot)
+    {
+      if (m_entries[slot].speed > 0)
+        {
+          Update (slot);
+        }
+      m_maxSpeed = std::max (m_maxSpeed, m_entries[slot].speed);
+    }
+  m_lastRefresh = Simulator::Now ();
+}
+
+void
+MobilityGrid::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator it = m_slots.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_slots.end ());
+  for (std::vector<uint32_t>::const_iterator i = it->second.begin (); i != it->second.end (); ++i)
+    {
+      Update (*i);
+      m_maxSpeed = std::max (m_maxSpeed, m_entries[*i].speed);
+    }
+}
+
+void
+MobilityGrid::GetCandidates (const Vector &center, double range, std::vector<uint32_t> &ids)
+{
+  NS_LOG_FUNCTION (this << center << range);
+  Time now = Simulator::Now ();
+  if (now < m_lastRefresh || now - m_lastRefresh >= m_refreshPeriod)
+    {
+      Refresh ();
+    }
+  // a model may have moved away from its cell since its last update
+  double reach = range + m_maxSpeed * (now - m_lastRefresh).GetSeconds ();
+  double xMin = std::floor ((center.x - reach) / m_cellSize);
+  double xMax = std::floor ((center.x + reach) / m_cellSize);
+  double yMin = std::floor ((center.y - reach) / m_cellSize);
+  double yMax = std::floor ((center.y + reach) / m_cellSize);
+
+  if ((xMax - xMin + 1) * (yMax - yMin + 1) > m_cells.size ())
+    {
+      // fewer occupied cells than cells in the search area
+      for (std::map<Cell, std::vector<uint32_t> >::const_iterator i = m_cells.begin (); i != m_cells.end (); ++i)
+        {
+          if (i->first.first >= xMin && i->first.first <= xMax
+              && i->first.second >= yMin && i->first.second <= yMax)
+            {
+              for (std::vector<uint32_t>::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+                {
+                  ids.push_back (m_entries[*j].id);
+                }
+            }
+        }
+      return;
+    }
+
+  for (int32_t x = static_cast<int32_t> (xMin); x <= static_cast<int32_t> (xMax); ++x)
+    {
+      for (int32_t y = static_cast<int32_t> (yMin); y <= static_cast<int32_t> (yMax); ++y)
+        {
+          std::map<Cell, std::vector<uint32_t> >::const_iterator i = m_cells.find (Cell (x, y));
+          if (i == m_cells.end ())
+            {
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+            {
+              ids.push_back (m_entries[*j].id);
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_H
+#define MOBILITY_GRID_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief a uniform grid over the positions of a set of mobility models
+ *
+ * Each mobility model added to the grid is stored in the square cell of
+ * the xy plane containing its position, so that the models within a
+ * given distance of a point are found by looking at a few cells only.
+ *
+ * A model is moved to its new cell whenever it fires its CourseChange
+ * trace.  Between two course changes a model moves at the velocity
+ * reported at the last one, so the distance it may have travelled since
+ * its cell was computed is bounded: GetCandidates widens the search by
+ * this distance, and the cells of the moving models are recomputed
+ * periodically to keep the widening small.  Models which move without
+ * notifying course changes (e.g., ConstantAccelerationMobilityModel)
+ * must not be added to the grid.
+ */
+class MobilityGrid : public SimpleRefCount<MobilityGrid>
+{
+public:
+  /**
+   * \param cellSize the size of the side of a cell, in meters
+   * \param refreshPeriod the period at which the cells of the moving
+   *        models are recomputed
+   */
+  MobilityGrid (double cellSize, Time refreshPeriod);
+  /**
+   * Disconnect from the mobility models.
+   */
+  ~MobilityGrid ();
+
+  /**
+   * \brief Add a mobility model to the grid
+   *
+   * A mobility model may be added several times, with different
+   * identifiers.
+   *
+   * \param mobility the mobility model
+   * \param id the identifier returned by GetCandidates for this model
+   */
+  void Add (Ptr<MobilityModel> mobility, uint32_t id);
+
+  /**
+   * \brief Remove all the mobility models from the grid
+   */
+  void Clear (void);
+
+  /**
+   * \returns the number of mobility models in the grid
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \brief Find the models which may be within a distance of a point
+   *
+   * All the models whose current distance to the point is not larger
+   * than the range are returned, possibly along with a few further ones.
+   * The order of the identifiers is unspecified.
+   *
+   * \param center the point
+   * \param range the distance, in meters
+   * \param ids [out] the identifiers of the models are appended to this vector
+   */
+  void GetCandidates (const Vector &center, double range, std::vector<uint32_t> &ids);
+
+private:
+  /**
+   * \brief Copy constructor: not implemented
+   * \param o object to copy
+   */
+  MobilityGrid (const MobilityGrid &o);
+  /**
+   * \brief Assignment operator: not implemented
+   * \param o object to copy
+   * \returns a reference to this object
+   */
+  MobilityGrid &operator = (const MobilityGrid &o);
+
+  /// Coordinates of a cell
+  typedef std::pair<int32_t, int32_t> Cell;
+
+  /// A mobility model in the grid
+  struct Entry
+  {
+    Ptr<MobilityModel> mobility;   //!< the mobility model
+    uint32_t id;                   //!< the identifier of the model
+    Cell cell;                     //!< the cell containing the model
+    double speed;                  //!< the speed of the model when its cell was computed
+  };
+
+  /**
+   * \param position a position
+   * \returns the cell containing the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * \brief Recompute the cell of an entry
+   * \param slot the index of the entry
+   */
+  void Update (uint32_t slot);
+  /**
+   * \brief Recompute the cells of the moving entries
+   */
+  void Refresh (void);
+  /**
+   * \brief CourseChange trace sink
+   * \param mobility the mobility model
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;               //!< size of the side of a cell
+  Time m_refreshPeriod;            //!< period of the refresh of the moving entries
+  Time m_lastRefresh;              //!< time of the last refresh
+  double m_maxSpeed;               //!< maximum speed of the entries
+  std::vector<Entry> m_entries;    //!< entries
+  std::map<Cell, std::vector<uint32_t> > m_cells;        //!< indexes of the entries of each cell
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_slots;     //!< indexes of the entries of each model
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_H */
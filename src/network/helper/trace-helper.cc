@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <string>
 #include <fstream>
+#include <map>
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
@@ -28,6 +29,7 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +37,25 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \brief State of the single pcapng file shared by all the pcap traces
+ */
+struct PcapSingleFile
+{
+  Ptr<PcapNgFile> file;                          //!< the shared file, if enabled
+  std::map<std::string, std::string> comments;   //!< interface comment by pcap file name
+};
+
+/**
+ * \returns the state of the single pcapng file
+ */
+static PcapSingleFile &
+GetPcapSingleFile (void)
+{
+  static PcapSingleFile singleFile;
+  return singleFile;
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +77,32 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+
+  PcapSingleFile &singleFile = GetPcapSingleFile ();
+  if (singleFile.file)
+    {
+      //
+      // The file name has been built out of the node and device names, so
+      // it is a reasonable interface name once the extension is dropped.
+      //
+      std::string name = filename;
+      std::string::size_type pos = name.rfind (".pcap");
+      if (pos != std::string::npos && pos + 5 == name.size ())
+        {
+          name.erase (pos);
+        }
+      std::string comment;
+      std::map<std::string, std::string>::iterator it = singleFile.comments.find (filename);
+      if (it != singleFile.comments.end ())
+        {
+          comment = it->second;
+          singleFile.comments.erase (it);
+        }
+      file->Init (singleFile.file, dataLinkType, name, comment, snapLen);
+      NS_ABORT_MSG_IF (file->Fail (), "Unable to add " << name << " to " << singleFile.file->GetFilename ());
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +123,42 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::EnableSingleFile (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  PcapSingleFile &singleFile = GetPcapSingleFile ();
+  singleFile.file = Create<PcapNgFile> ();
+  singleFile.file->Open (filename);
+  singleFile.comments.clear ();
+  NS_ABORT_MSG_IF (singleFile.file->Fail (), "Unable to Open " << filename);
+}
+
+void
+PcapHelper::DisableSingleFile (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  PcapSingleFile &singleFile = GetPcapSingleFile ();
+  singleFile.file = 0;
+  singleFile.comments.clear ();
+}
+
+bool
+PcapHelper::IsSingleFileEnabled (void)
+{
+  return GetPcapSingleFile ().file != 0;
+}
+
+void
+PcapHelper::SetSingleFileComment (std::string filename, std::string comment)
+{
+  PcapSingleFile &singleFile = GetPcapSingleFile ();
+  if (singleFile.file)
+    {
+      singleFile.comments[filename] = comment;
+    }
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -118,6 +201,23 @@ PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bo
 
   oss << ".pcap";
 
+  if (IsSingleFileEnabled ())
+    {
+      std::ostringstream comment;
+      comment << "node " << node->GetId ();
+      if (nodename.size ())
+        {
+          comment << " (" << nodename << ")";
+        }
+      comment << ", device " << device->GetIfIndex ();
+      if (devicename.size ())
+        {
+          comment << " (" << devicename << ")";
+        }
+      comment << ", " << device->GetInstanceTypeId ().GetName ();
+      SetSingleFileComment (oss.str (), comment.str ());
+    }
+
   return oss.str ();
 }
 
@@ -156,6 +256,22 @@ PcapHelper::GetFilenameFromInterfacePair (std::string prefix, Ptr<Object> object
 
   oss << "-i" << interface << ".pcap";
 
+  if (IsSingleFileEnabled ())
+    {
+      std::ostringstream comment;
+      comment << "node " << node->GetId ();
+      if (nodename.size ())
+        {
+          comment << " (" << nodename << ")";
+        }
+      if (objname.size ())
+        {
+          comment << ", " << objname;
+        }
+      comment << ", interface " << interface;
+      SetSingleFileComment (oss.str (), comment.str ());
+    }
+
   return oss.str ();
 }
 
@@ -208,6 +324,16 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (filename << snapLen);
+
+  Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, std::ios::out | std::ios::binary);
+  StreamWrapper->SetBinaryFormat (snapLen);
+  return StreamWrapper;
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -310,6 +436,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('+', std::string (), p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +449,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('+', context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +474,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('d', std::string (), p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +487,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('d', context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +513,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('-', std::string (), p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +526,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('-', context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +549,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('r', std::string (), p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +562,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer)
+    {
+      writer->Write ('r', context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
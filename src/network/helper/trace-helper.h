@@ -109,6 +109,38 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+
+  /**
+   * @brief Capture all the pcap traces created from now on in a single file.
+   *
+   * Large topologies produce one pcap file per traced device, which can
+   * exhaust the available file descriptors and is slow to manage.  After
+   * this call, every file created by CreateFile (and therefore by the
+   * EnablePcap family of methods of all device helpers) becomes one
+   * interface of a single pcapng file, whose name is the one that the pcap
+   * file would have had.  The node and device names are recorded as the
+   * interface comment.
+   *
+   * Packets are timestamped with nanosecond resolution and written through
+   * one buffered stream; the file is flushed and closed when the last
+   * device trace and DisableSingleFile have released it.
+   *
+   * @param filename name of the pcapng file
+   */
+  static void EnableSingleFile (std::string filename);
+
+  /**
+   * @brief Go back to one pcap file per trace for the files created from now on.
+   *
+   * The traces already directed to the single pcapng file keep using it.
+   */
+  static void DisableSingleFile (void);
+
+  /**
+   * @returns true if the pcap traces are captured in a single pcapng file
+   */
+  static bool IsSingleFileEnabled (void);
+
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -141,6 +173,17 @@ private:
    * @see DefaultSink
    */
   static void SinkWithHeader (Ptr<PcapFileWrapper> file, const Header& header, Ptr<const Packet> p);
+
+  /**
+   * @brief Remember the description of the trace stored in a file
+   *
+   * Only used when the traces are captured in a single pcapng file, where
+   * the description becomes the comment of the interface.
+   *
+   * @param filename file name
+   * @param comment description of the traced device or interface
+   */
+  static void SetSingleFileComment (std::string filename, std::string comment);
 };
 
 template <typename T> void
@@ -222,6 +265,29 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create an output stream on which the default trace sinks write
+   * binary trace records instead of text.
+   *
+   * Printing every packet with Packet::Print is slow and produces large
+   * files.  When a stream created by this method is passed to the
+   * EnableAscii methods of the device helpers, the default enqueue, dequeue,
+   * drop and receive sinks store a fixed-size BinaryTraceRecord per event
+   * (event type, time, node, device, packet uid and size), optionally
+   * followed by the first snapLen bytes of the packet, which hold its
+   * headers.  Records are buffered and written in large chunks.  The
+   * print-binary-trace utility converts the file back to text.
+   *
+   * Only the default trace sinks of this class know about binary streams,
+   * so such a stream must not be passed to helpers that install their own
+   * ascii trace sinks.
+   *
+   * @param filename file name
+   * @param snapLen maximum number of packet bytes stored with each record
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename, uint32_t snapLen = 0);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
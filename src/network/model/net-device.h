@@ -34,6 +34,7 @@ namespace ns3 {
 
 class Node;
 class Channel;
+class PacketBurst;
 
 /**
  * \ingroup network
@@ -260,6 +261,23 @@ public:
    * \return whether the Send operation succeeded 
    */
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber) = 0;
+  /**
+   * \param burst packets sent from above down to Network Device, in order
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber identifies the type of payload contained in
+   *        the packets. Used to call the right L3Protocol when the packets
+   *        are received.
+   *
+   *  Called from higher layer to send back-to-back packets into Network
+   *  Device to the specified destination Address.  Devices which can
+   *  transmit the packets as a single unit override this method to
+   *  schedule one transmit completion event for the whole burst, rather
+   *  than one per packet.  The default implementation calls Send for each
+   *  packet of the burst.
+   *
+   * \return whether the Send operation succeeded for all the packets
+   */
+  virtual bool SendBurst (Ptr<PacketBurst> burst, const Address& dest, uint16_t protocolNumber);
   /**
    * \returns the node base class which contains this network
    *          interface.
@@ -34,6 +34,9 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
+bool PacketMetadata::m_sampling = false;
+uint32_t PacketMetadata::m_samplingPeriod = 0;
+PacketMetadata::SamplingCallback PacketMetadata::m_samplingPredicate;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
@@ -46,6 +49,7 @@ PacketMetadata::DataFreeList::~DataFreeList ()
       PacketMetadata::Deallocate (*i);
     }
   PacketMetadata::m_enable = false;
+  PacketMetadata::m_sampling = false;
 }
 
 void 
@@ -70,6 +74,64 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableSampling (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  m_samplingPeriod = n;
+  m_samplingPredicate = SamplingCallback ();
+  m_sampling = (n != 0);
+}
+
+void
+PacketMetadata::EnableSampling (SamplingCallback predicate)
+{
+  NS_LOG_FUNCTION (&predicate);
+  m_samplingPeriod = 0;
+  m_samplingPredicate = predicate;
+  m_sampling = !predicate.IsNull ();
+}
+
+bool
+PacketMetadata::IsSampled (uint64_t uid, uint32_t size)
+{
+  if (!m_samplingPredicate.IsNull ())
+    {
+      return m_samplingPredicate (uid, size);
+    }
+  // the lower 32 bits of the uid are the global packet counter
+  return (uid & 0xffffffff) % m_samplingPeriod == 0;
+}
+
+bool
+PacketMetadata::IsEnabled (void) const
+{
+  return m_enabled;
+}
+
+PacketMetadata::Settings
+PacketMetadata::GetSettings (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Settings settings;
+  settings.enable = m_enable;
+  settings.metadataSkipped = m_metadataSkipped;
+  settings.samplingPeriod = m_samplingPeriod;
+  settings.samplingPredicate = m_samplingPredicate;
+  return settings;
+}
+
+void
+PacketMetadata::SetSettings (const Settings &settings)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_enable = settings.enable;
+  m_metadataSkipped = settings.metadataSkipped;
+  m_samplingPeriod = settings.samplingPeriod;
+  m_samplingPredicate = settings.samplingPredicate;
+  m_sampling = (m_samplingPeriod != 0 || !m_samplingPredicate.IsNull ());
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -596,7 +658,7 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
+  if (!m_enable && !m_sampling)
     {
       PacketMetadata::Deallocate (data);
       return;
@@ -663,7 +725,7 @@ void
 PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
 {
   NS_LOG_FUNCTION (this << uid << size);
-  if (!m_enable)
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -685,7 +747,7 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -733,7 +795,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable)
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -755,7 +817,7 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
   uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -802,11 +864,21 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
 {
   NS_LOG_FUNCTION (this << &o);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
     }
+  if (!o.m_enabled)
+    {
+      // The metadata of the other packet was not recorded, so that of
+      // the result would be incomplete: drop ours.
+      m_metadataSkipped = true;
+      m_enabled = false;
+      m_head = 0xffff;
+      m_tail = 0xffff;
+      return;
+    }
   if (m_tail == 0xffff)
     {
       // We have no items so 'AddAtEnd' is 
@@ -879,7 +951,7 @@ void
 PacketMetadata::AddPaddingAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
-  if (!m_enable)
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -890,7 +962,7 @@ PacketMetadata::RemoveAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -953,7 +1025,7 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_enabled)
     {
       m_metadataSkipped = true;
       return;
@@ -1141,10 +1213,17 @@ PacketMetadata::GetSerializedSize (void) const
   // if packet-metadata not enabled, total size
   // is simply 4-bytes for itself plus 8-bytes 
   // for packet uid
-  if (!m_enable)
+  if (!m_enabled)
     {
       return totalSize;
     }
+  // when only the sampled packets have metadata, a packet with metadata
+  // but no items is marked by a single byte, so that it keeps its
+  // metadata once deserialized; the format is unchanged otherwise
+  if (m_head == 0xffff && m_sampling && !m_enable)
+    {
+      return totalSize + 1;
+    }
 
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
@@ -1185,6 +1264,14 @@ PacketMetadata::Serialize (uint8_t* buffer, uint32_t maxSize) const
     {
       return 0;
     }
+  if (m_enabled && m_head == 0xffff && m_sampling && !m_enable)
+    {
+      buffer = AddToRawU8 (0, start, buffer, maxSize);
+      if (buffer == 0)
+        {
+          return 0;
+        }
+    }
 
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
@@ -1284,6 +1371,14 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
 
   buffer = ReadFromRawU64 (m_packetUid, start, buffer, size);
   desSize -= 8;
+  // a sampled packet carries its items, or the marker of an empty list
+  m_enabled = m_enable || desSize > 0;
+  if (desSize == 1)
+    {
+      uint8_t marker = 0;
+      buffer = ReadFromRawU8 (marker, start, buffer, size);
+      desSize--;
+    }
 
   struct PacketMetadata::SmallItem item = {0};
   struct PacketMetadata::ExtraItem extraItem = {0};
@@ -28,6 +28,8 @@
 #include "ns3/type-id.h"
 #include "buffer.h"
 
+class PacketMetadataSamplingTest;
+
 namespace ns3 {
 
 class Chunk;
@@ -159,6 +161,36 @@ private:
    * \brief Enable the packet metadata checking
    */
   static void EnableChecking (void);
+  /**
+   * \brief Predicate selecting the packets which keep metadata
+   *
+   * The arguments are the uid and the initial size of the packet
+   * being created.
+   */
+  typedef Callback<bool, uint64_t, uint32_t> SamplingCallback;
+  /**
+   * \brief Enable the packet metadata for one packet out of n
+   *
+   * Only packets created after this call are sampled, selected by
+   * their uid.  Packets which are not sampled skip all metadata
+   * bookkeeping, and copies or fragments of a sampled packet keep
+   * their metadata.
+   *
+   * \param n the sampling period; 0 disables sampling
+   */
+  static void EnableSampling (uint32_t n);
+  /**
+   * \brief Enable the packet metadata for the packets matching a predicate
+   *
+   * The predicate is evaluated when a packet is created.
+   *
+   * \param predicate the predicate; a null callback disables sampling
+   */
+  static void EnableSampling (SamplingCallback predicate);
+  /**
+   * \returns true if metadata is recorded for this packet
+   */
+  bool IsEnabled (void) const;
 
   /**
    * \brief Constructor
@@ -271,6 +303,32 @@ private:
   uint32_t Deserialize (const uint8_t* buffer, uint32_t size);
 
 private:
+  /// Allow the sampling test to save and restore the global settings
+  friend class ::PacketMetadataSamplingTest;
+
+  /**
+   * \brief The global settings of the packet metadata
+   *
+   * Enable can not be undone, so the tests which change these
+   * settings save and restore them.
+   */
+  struct Settings
+  {
+    bool enable; //!< metadata recorded for all packets
+    bool metadataSkipped; //!< metadata already skipped for some packets
+    uint32_t samplingPeriod; //!< sampling period, if not zero
+    SamplingCallback samplingPredicate; //!< sampling predicate, if not null
+  };
+  /**
+   * \returns the current global settings
+   */
+  static Settings GetSettings (void);
+  /**
+   * \brief Restore the global settings
+   * \param settings the settings returned by GetSettings
+   */
+  static void SetSettings (const Settings &settings);
+
   /**
    * \brief Helper for the raw serialization.
    *
@@ -667,6 +725,18 @@ public:
    */
   static bool m_metadataSkipped;
 
+  /**
+   * \brief Decide whether a new packet keeps metadata, when sampling
+   * \param uid the packet uid
+   * \param size the initial size of the packet
+   * \returns true if the packet is sampled
+   */
+  static bool IsSampled (uint64_t uid, uint32_t size);
+
+  static bool m_sampling; //!< Enable the packet metadata for sampled packets only
+  static uint32_t m_samplingPeriod; //!< Sample one packet out of m_samplingPeriod, if not zero
+  static SamplingCallback m_samplingPredicate; //!< Sampling predicate, if not null
+
   static uint32_t m_maxSize; //!< maximum metadata size
   static uint16_t m_chunkUid; //!< Chunk Uid
 
@@ -679,6 +749,7 @@ public:
   uint16_t m_head; //!< list head
   uint16_t m_tail; //!< list tail
   uint16_t m_used; //!< used portion
+  bool m_enabled; //!< true if metadata is recorded for this packet
   uint64_t m_packetUid; //!< packet Uid
 };
 
@@ -691,6 +762,7 @@ PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
+    m_enabled (m_enable || (m_sampling && IsSampled (uid, size))),
     m_packetUid (uid)
 {
   memset (m_data->m_data, 0xff, 4);
@@ -704,6 +776,7 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
     m_head (o.m_head),
     m_tail (o.m_tail),
     m_used (o.m_used),
+    m_enabled (o.m_enabled),
     m_packetUid (o.m_packetUid)
 {
   NS_ASSERT (m_data != 0);
@@ -729,6 +802,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
   m_head = o.m_head;
   m_tail = o.m_tail;
   m_used = o.m_used;
+  m_enabled = o.m_enabled;
   m_packetUid = o.m_packetUid;
   return *this;
 }
@@ -544,6 +544,26 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableSampledPrinting (uint32_t n)
+{
+  NS_LOG_FUNCTION (n);
+  PacketMetadata::EnableSampling (n);
+}
+
+void
+Packet::EnableSampledPrinting (PacketMetadata::SamplingCallback predicate)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  PacketMetadata::EnableSampling (predicate);
+}
+
+bool
+Packet::HasMetadata (void) const
+{
+  return m_metadata.IsEnabled ();
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
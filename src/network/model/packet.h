@@ -501,6 +501,32 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable printing the metadata of one packet out of n.
+   *
+   * Unlike EnablePrinting, only the sampled packets pay for the
+   * metadata bookkeeping: the Print methods and BeginItem return
+   * nothing for the other packets.  This method can be called at any
+   * time; it affects the packets created after the call.
+   *
+   * \param n the sampling period; 0 disables sampling
+   */
+  static void EnableSampledPrinting (uint32_t n);
+  /**
+   * \brief Enable printing the metadata of the packets matching a predicate.
+   *
+   * The predicate is invoked with the uid and the size of each packet
+   * created after this call.
+   *
+   * \param predicate the predicate; a null callback disables sampling
+   * \sa EnableSampledPrinting (uint32_t)
+   */
+  static void EnableSampledPrinting (PacketMetadata::SamplingCallback predicate);
+  /**
+   * \returns true if the metadata of this packet is recorded, either
+   *          because printing is enabled or because the packet is sampled.
+   */
+  bool HasMetadata (void) const;
 
   /**
    * \brief Returns number of bytes required for packet
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/binary-trace.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case to make sure that the default ascii trace sinks write binary
+// records to a binary stream, and that they can be read back.
+// ===========================================================================
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  BinaryTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Fire the default trace sinks
+   * \param stream the stream
+   */
+  void FireSinks (Ptr<OutputStreamWrapper> stream);
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase ()
+  : TestCase ("Check that binary trace records are written and read back")
+{
+}
+
+void
+BinaryTraceTestCase::FireSinks (Ptr<OutputStreamWrapper> stream)
+{
+  uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  Ptr<Packet> p = Create<Packet> (data, sizeof (data));
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, "/NodeList/3/DeviceList/1/$ns3::PointToPointNetDevice/TxQueue/Enqueue", p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, p);
+  AsciiTraceHelper::DefaultDropSinkWithContext (stream, "/NodeList/12/ApplicationList/0", p);
+  AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, "/NodeList/4/DeviceList/2/MacRx", Create<Packet> (1000));
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-trace.btr");
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateBinaryFileStream (filename, 4);
+
+  Simulator::ScheduleWithContext (7, Seconds (1.5), &BinaryTraceTestCase::FireSinks, this, stream);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // releasing the stream flushes the records
+  stream = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Unable to open " << filename);
+  NS_TEST_EXPECT_MSG_EQ (reader.GetSnapLen (), 4, "Wrong snap length");
+
+  uint8_t types[4] = { '+', '-', 'd', 'r' };
+  uint32_t nodes[4] = { 3, 7, 12, 4 };
+  uint32_t devices[4] = { 1, BinaryTraceRecord::NO_ID, BinaryTraceRecord::NO_ID, 2 };
+  uint32_t sizes[4] = { 8, 8, 8, 1000 };
+  BinaryTraceRecord record;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reader.Read (record), true, "Unable to read record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_type, types[i], "Wrong type in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_node, nodes[i], "Wrong node in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_device, devices[i], "Wrong device in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_size, sizes[i], "Wrong size in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_time, 1500000000, "Wrong time in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.m_capLen, 4, "Wrong captured length in record " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (record.m_data[0], 0, "Wrong captured bytes");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read (record), false, "Unexpected record at the end of the file");
+  reader.Close ();
+}
+
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite;
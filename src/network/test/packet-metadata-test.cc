@@ -823,6 +823,162 @@ PacketMetadataTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
 }
 //-----------------------------------------------------------------------------
+class PacketMetadataSamplingTest : public TestCase {
+public:
+  PacketMetadataSamplingTest ();
+  virtual void DoRun (void);
+private:
+  static bool IsLarge (uint64_t uid, uint32_t size);
+  static uint32_t CountItems (Ptr<const Packet> p);
+  static Ptr<Packet> SerializeRoundTrip (Ptr<const Packet> p);
+};
+
+PacketMetadataSamplingTest::PacketMetadataSamplingTest ()
+  : TestCase ("Packet metadata sampling")
+{
+}
+
+bool
+PacketMetadataSamplingTest::IsLarge (uint64_t uid, uint32_t size)
+{
+  return size >= 100;
+}
+
+uint32_t
+PacketMetadataSamplingTest::CountItems (Ptr<const Packet> p)
+{
+  uint32_t n = 0;
+  PacketMetadata::ItemIterator k = p->BeginItem ();
+  while (k.HasNext ())
+    {
+      k.Next ();
+      n++;
+    }
+  return n;
+}
+
+Ptr<Packet>
+PacketMetadataSamplingTest::SerializeRoundTrip (Ptr<const Packet> p)
+{
+  uint32_t size = p->GetSerializedSize ();
+  uint8_t* buffer = new uint8_t[size];
+  p->Serialize (buffer, size);
+  Ptr<Packet> otherPacket = Create<Packet> (buffer, size, true);
+  delete [] buffer;
+  return otherPacket;
+}
+
+void
+PacketMetadataSamplingTest::DoRun (void)
+{
+  // the other test case enables the metadata of all packets
+  PacketMetadata::Settings settings = PacketMetadata::GetSettings ();
+  PacketMetadata::Settings sampling = settings;
+  sampling.enable = false;
+  sampling.metadataSkipped = false;
+  sampling.samplingPeriod = 0;
+  sampling.samplingPredicate = PacketMetadata::SamplingCallback ();
+  PacketMetadata::SetSettings (sampling);
+
+  // one packet out of n, by uid
+  Packet::EnableSampledPrinting (4);
+  uint32_t nSampled = 0;
+  Ptr<Packet> sampled;
+  Ptr<Packet> unsampled;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (10);
+      ADD_HEADER (p, 10);
+      bool expected = (p->GetUid () & 0xffffffff) % 4 == 0;
+      NS_TEST_EXPECT_MSG_EQ (p->HasMetadata (), expected, "Wrong sampling of packet " << p->GetUid ());
+      NS_TEST_EXPECT_MSG_EQ (CountItems (p), expected ? 2 : 0, "Wrong number of items of packet " << p->GetUid ());
+      if (expected)
+        {
+          nSampled++;
+          sampled = p;
+        }
+      else
+        {
+          unsampled = p;
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (nSampled, 2, "Wrong number of sampled packets");
+
+  // copies and fragments inherit the flag
+  Ptr<Packet> copy = sampled->Copy ();
+  NS_TEST_EXPECT_MSG_EQ (copy->HasMetadata (), true, "The copy of a sampled packet lost its metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (copy), 2, "Wrong number of items of the copy");
+  Ptr<Packet> fragment = sampled->CreateFragment (0, 15);
+  NS_TEST_EXPECT_MSG_EQ (fragment->HasMetadata (), true, "The fragment of a sampled packet lost its metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (fragment), 2, "Wrong number of items of the fragment");
+  NS_TEST_EXPECT_MSG_EQ (unsampled->Copy ()->HasMetadata (), false, "The copy of an unsampled packet has metadata");
+
+  // appending an unsampled packet drops the metadata
+  copy->AddAtEnd (unsampled);
+  NS_TEST_EXPECT_MSG_EQ (copy->HasMetadata (), false, "Appending an unsampled packet kept the metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (copy), 0, "Appending an unsampled packet kept the items");
+  NS_TEST_EXPECT_MSG_EQ (sampled->HasMetadata (), true, "Appending to a copy changed the original packet");
+  Ptr<Packet> appended = sampled->Copy ();
+  appended->AddAtEnd (sampled);
+  NS_TEST_EXPECT_MSG_EQ (CountItems (appended), 4, "Wrong number of items after appending a sampled packet");
+
+  // serialization round-trips keep the flag, even without items
+  Ptr<Packet> restored = SerializeRoundTrip (sampled);
+  NS_TEST_EXPECT_MSG_EQ (restored->HasMetadata (), true, "A deserialized sampled packet lost its metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (restored), 2, "Wrong number of items of a deserialized sampled packet");
+  restored = SerializeRoundTrip (unsampled);
+  NS_TEST_EXPECT_MSG_EQ (restored->HasMetadata (), false, "A deserialized unsampled packet has metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (restored), 0, "A deserialized unsampled packet has items");
+  Ptr<Packet> empty;
+  do
+    {
+      empty = Create<Packet> ();
+    }
+  while (!empty->HasMetadata ());
+  restored = SerializeRoundTrip (empty);
+  NS_TEST_EXPECT_MSG_EQ (restored->HasMetadata (), true, "A deserialized sampled packet without items lost its metadata");
+  ADD_HEADER (restored, 10);
+  NS_TEST_EXPECT_MSG_EQ (CountItems (restored), 1, "A deserialized sampled packet without items does not record its headers");
+
+  // sampling by a predicate
+  Packet::EnableSampledPrinting (MakeCallback (&PacketMetadataSamplingTest::IsLarge));
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (50 * i);
+      NS_TEST_EXPECT_MSG_EQ (p->HasMetadata (), (50 * i >= 100), "Wrong sampling of a packet of " << 50 * i << " bytes");
+    }
+
+  // the metadata of the recycled packets is reused by the sampled packets
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100 + i % 2);
+      ADD_HEADER (p, 10);
+      ADD_TRAILER (p, 4);
+      NS_TEST_EXPECT_MSG_EQ (CountItems (p), 3, "Wrong number of items of a packet reusing recycled metadata");
+      Ptr<Packet> small = Create<Packet> (10);
+      ADD_HEADER (small, 10);
+      NS_TEST_EXPECT_MSG_EQ (CountItems (small), 0, "An unsampled packet reusing recycled metadata has items");
+    }
+  Packet::EnableSampledPrinting (0);
+  Ptr<Packet> p = Create<Packet> (100);
+  ADD_HEADER (p, 10);
+  NS_TEST_EXPECT_MSG_EQ (p->HasMetadata (), false, "A packet has metadata after sampling was disabled");
+  NS_TEST_EXPECT_MSG_EQ (sampled->HasMetadata (), true, "Disabling sampling dropped the metadata of an earlier packet");
+  NS_TEST_EXPECT_MSG_EQ (CountItems (sampled), 2, "Disabling sampling dropped the items of an earlier packet");
+
+  // without sampling, the serialized form of an empty packet is the same
+  // whether the metadata is enabled or not
+  Ptr<Packet> disabled = Create<Packet> ();
+  sampling.enable = true;
+  PacketMetadata::SetSettings (sampling);
+  Ptr<Packet> enabled = Create<Packet> ();
+  NS_TEST_EXPECT_MSG_EQ (enabled->HasMetadata (), true, "A packet has no metadata after Enable");
+  NS_TEST_EXPECT_MSG_EQ (enabled->GetSerializedSize (), disabled->GetSerializedSize (),
+                         "Enabling the metadata changed the serialized size of an empty packet");
+
+  PacketMetadata::SetSettings (settings);
+}
+//-----------------------------------------------------------------------------
 class PacketMetadataTestSuite : public TestSuite
 {
 public:
@@ -833,6 +989,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
+  AddTestCase (new PacketMetadataSamplingTest, TestCase::QUICK);
 }
 
 PacketMetadataTestSuite g_packetMetadataTest;
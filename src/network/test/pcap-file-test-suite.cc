@@ -21,10 +21,14 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/packet.h"
+#include "ns3/trace-helper.h"
 
 using namespace ns3;
 
@@ -1121,6 +1125,125 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that the pcap helper can capture several traces
+// in a single pcapng file.
+// ===========================================================================
+class SingleFileTestCase : public TestCase
+{
+public:
+  SingleFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SingleFileTestCase::SingleFileTestCase ()
+  : TestCase ("Check that PcapHelper can write several traces into a single pcapng file")
+{
+}
+
+/**
+ * Read the type and the total length of the next pcapng block and skip
+ * the rest of it.
+ *
+ * \param p the file
+ * \param type [out] the block type
+ * \param body [out] the first bytes of the block body
+ * \param bodyLen the size of the body buffer
+ * \returns the total length of the block, 0 on error
+ */
+static uint32_t
+ReadBlock (FILE *p, uint32_t &type, uint8_t *body, uint32_t bodyLen)
+{
+  uint32_t length;
+  if (std::fread (&type, sizeof (type), 1, p) != 1 || std::fread (&length, sizeof (length), 1, p) != 1)
+    {
+      return 0;
+    }
+  if (length < 12 || (length % 4) != 0)
+    {
+      return 0;
+    }
+  std::vector<uint8_t> rest (length - 8);
+  if (std::fread (&rest[0], rest.size (), 1, p) != 1)
+    {
+      return 0;
+    }
+  std::memcpy (body, &rest[0], std::min<uint32_t> (bodyLen, rest.size () - 4));
+  uint32_t trailer;
+  std::memcpy (&trailer, &rest[rest.size () - 4], sizeof (trailer));
+  return trailer == length ? length : 0;
+}
+
+void
+SingleFileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("single-file.pcapng");
+  PcapHelper pcapHelper;
+
+  PcapHelper::EnableSingleFile (filename);
+  NS_TEST_ASSERT_MSG_EQ (PcapHelper::IsSingleFileEnabled (), true, "Single file mode not enabled");
+  Ptr<PcapFileWrapper> ppp = pcapHelper.CreateFile ("ppp.pcap", std::ios::out, PcapHelper::DLT_PPP);
+  Ptr<PcapFileWrapper> eth = pcapHelper.CreateFile ("eth.pcap", std::ios::out, PcapHelper::DLT_EN10MB, 20);
+  PcapHelper::DisableSingleFile ();
+  NS_TEST_ASSERT_MSG_EQ (PcapHelper::IsSingleFileEnabled (), false, "Single file mode not disabled");
+  NS_TEST_ASSERT_MSG_EQ (eth->GetDataLinkType (), PcapHelper::DLT_EN10MB, "Wrong data link type");
+
+  ppp->Write (NanoSeconds (1500), Create<Packet> (10));
+  eth->Write (Seconds (5), Create<Packet> (100));
+  NS_TEST_ASSERT_MSG_EQ (eth->Fail (), false, "Write must not fail");
+  // releasing the last references closes the shared file
+  ppp = 0;
+  eth = 0;
+
+  FILE *p = std::fopen (filename.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (p, 0, "fopen(" << filename << ") should have been able to open the pcapng file");
+
+  uint32_t type;
+  uint8_t body[20];
+  uint32_t val32;
+  uint16_t val16;
+
+  NS_TEST_EXPECT_MSG_EQ (ReadBlock (p, type, body, sizeof (body)), 28, "Wrong section header block length");
+  NS_TEST_EXPECT_MSG_EQ (type, 0x0a0d0d0a, "Wrong section header block type");
+  std::memcpy (&val32, body, 4);
+  NS_TEST_EXPECT_MSG_EQ (val32, 0x1a2b3c4d, "Wrong byte order magic");
+
+  uint16_t linkTypes[2] = { PcapHelper::DLT_PPP, PcapHelper::DLT_EN10MB };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_EXPECT_MSG_NE (ReadBlock (p, type, body, sizeof (body)), 0, "Invalid interface description block");
+      NS_TEST_EXPECT_MSG_EQ (type, 1, "Wrong interface description block type");
+      std::memcpy (&val16, body, 2);
+      NS_TEST_EXPECT_MSG_EQ (val16, linkTypes[i], "Wrong interface data link type");
+    }
+
+  uint32_t inclLens[2] = { 10, 20 };
+  uint32_t origLens[2] = { 10, 100 };
+  uint64_t timestamps[2] = { 1500, 5000000000ULL };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (ReadBlock (p, type, body, sizeof (body)), 32 + ((inclLens[i] + 3) & ~3U),
+                             "Wrong enhanced packet block length");
+      NS_TEST_EXPECT_MSG_EQ (type, 6, "Wrong enhanced packet block type");
+      std::memcpy (&val32, body, 4);
+      NS_TEST_EXPECT_MSG_EQ (val32, i, "Wrong interface identifier");
+      uint32_t tsHigh, tsLow;
+      std::memcpy (&tsHigh, body + 4, 4);
+      std::memcpy (&tsLow, body + 8, 4);
+      uint64_t ts = (uint64_t (tsHigh) << 32) | tsLow;
+      NS_TEST_EXPECT_MSG_EQ (ts, timestamps[i], "Wrong timestamp");
+      std::memcpy (&val32, body + 12, 4);
+      NS_TEST_EXPECT_MSG_EQ (val32, inclLens[i], "Wrong captured length");
+      std::memcpy (&val32, body + 16, 4);
+      NS_TEST_EXPECT_MSG_EQ (val32, origLens[i], "Wrong original length");
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (ReadBlock (p, type, body, sizeof (body)), 0, "Unexpected block at the end of the file");
+  std::fclose (p);
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1261,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new SingleFileTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
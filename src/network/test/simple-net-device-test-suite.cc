@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/packet-burst.h"
+#include "ns3/data-rate.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+
+using namespace ns3;
+
+/**
+ * Send bursts of packets over a SimpleChannel, and check that each
+ * receiver gets every packet once, in order.  The second burst is sent
+ * while the first one is being transmitted, so it goes through the
+ * transmit queue of the sender.
+ */
+class SimpleNetDeviceBurstTestCase : public TestCase
+{
+public:
+  SimpleNetDeviceBurstTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record a received packet
+   * \param device the receiving device
+   * \param packet the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<uint64_t> m_received[2]; //!< uids of the packets received by each receiver
+  Ptr<NetDevice> m_receivers[2];       //!< the receivers
+};
+
+SimpleNetDeviceBurstTestCase::SimpleNetDeviceBurstTestCase ()
+  : TestCase ("Send packet bursts over a SimpleChannel")
+{
+}
+
+bool
+SimpleNetDeviceBurstTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      if (device == m_receivers[i])
+        {
+          m_received[i].push_back (packet->GetUid ());
+        }
+    }
+  return true;
+}
+
+void
+SimpleNetDeviceBurstTestCase::DoRun (void)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  std::vector<Ptr<SimpleNetDevice> > devices;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetAttribute ("DataRate", DataRateValue (DataRate ("1Mbps")));
+      device->SetChannel (channel);
+      node->AddDevice (device);
+      device->SetReceiveCallback (MakeCallback (&SimpleNetDeviceBurstTestCase::Receive, this));
+      devices.push_back (device);
+    }
+  m_receivers[0] = devices[1];
+  m_receivers[1] = devices[2];
+
+  std::vector<uint64_t> sent;
+  Ptr<PacketBurst> bursts[2];
+  for (uint32_t b = 0; b < 2; ++b)
+    {
+      bursts[b] = Create<PacketBurst> ();
+      for (uint32_t i = 0; i < 5; ++i)
+        {
+          Ptr<Packet> packet = Create<Packet> (100 + 100 * i);
+          sent.push_back (packet->GetUid ());
+          bursts[b]->AddPacket (packet);
+        }
+    }
+
+  Simulator::Schedule (Seconds (1), &SimpleNetDevice::SendBurst, devices[0], bursts[0],
+                       devices[0]->GetBroadcast (), 0x800);
+  // during the transmission of the first burst
+  Simulator::Schedule (Seconds (1.001), &SimpleNetDevice::SendBurst, devices[0], bursts[1],
+                       devices[0]->GetBroadcast (), 0x800);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t r = 0; r < 2; ++r)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[r].size (), sent.size (), "Wrong number of packets received by receiver " << r);
+      for (uint32_t i = 0; i < sent.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_received[r][i], sent[i], "Wrong packet " << i << " received by receiver " << r);
+        }
+    }
+  m_receivers[0] = 0;
+  m_receivers[1] = 0;
+}
+
+/**
+ * \brief SimpleNetDevice test suite
+ */
+class SimpleNetDeviceTestSuite : public TestSuite
+{
+public:
+  SimpleNetDeviceTestSuite ();
+};
+
+SimpleNetDeviceTestSuite::SimpleNetDeviceTestSuite ()
+  : TestSuite ("simple-net-device", UNIT)
+{
+  AddTestCase (new SimpleNetDeviceBurstTestCase, TestCase::QUICK);
+}
+
+static SimpleNetDeviceTestSuite g_simpleNetDeviceTestSuite;
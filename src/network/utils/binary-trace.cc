@@ -0,0 +1,284 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "binary-trace.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTrace");
+
+/// Size of the file header
+static const uint32_t FILE_HEADER_SIZE = 16;
+
+/**
+ * \brief Append a value to a buffer, in host byte order
+ * \param buffer the buffer
+ * \param val the value
+ */
+template <typename T>
+static void
+Append (std::vector<uint8_t> &buffer, T val)
+{
+  const uint8_t *p = reinterpret_cast<const uint8_t *> (&val);
+  buffer.insert (buffer.end (), p, p + sizeof (T));
+}
+
+/**
+ * \brief Decode a value, in host byte order
+ * \param p where to read the value
+ * \returns the value
+ */
+template <typename T>
+static T
+Extract (const uint8_t *p)
+{
+  T val;
+  std::memcpy (&val, p, sizeof (T));
+  return val;
+}
+
+BinaryTraceWriter::BinaryTraceWriter (std::ostream *os, uint32_t snapLen)
+  : m_os (os),
+    m_snapLen (std::min<uint32_t> (snapLen, 0xffff))
+{
+  NS_LOG_FUNCTION (this << os << snapLen);
+  m_buffer.reserve (BUFFER_SIZE);
+  Append<uint32_t> (m_buffer, MAGIC);
+  Append<uint16_t> (m_buffer, VERSION_MAJOR);
+  Append<uint16_t> (m_buffer, VERSION_MINOR);
+  Append<uint32_t> (m_buffer, m_snapLen);
+  Append<uint32_t> (m_buffer, 0);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+uint32_t
+BinaryTraceWriter::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+void
+BinaryTraceWriter::ParseContext (std::string const &context, uint32_t &node, uint32_t &device)
+{
+  static const char nodeList[] = "/NodeList/";
+  static const char deviceList[] = "/DeviceList/";
+  node = BinaryTraceRecord::NO_ID;
+  device = BinaryTraceRecord::NO_ID;
+
+  std::string::size_type pos = context.find (nodeList);
+  if (pos == std::string::npos)
+    {
+      return;
+    }
+  const char *start = context.c_str () + pos + sizeof (nodeList) - 1;
+  char *end;
+  node = std::strtoul (start, &end, 10);
+  if (end == start)
+    {
+      node = BinaryTraceRecord::NO_ID;
+      return;
+    }
+  if (std::strncmp (end, deviceList, sizeof (deviceList) - 1) == 0)
+    {
+      start = end + sizeof (deviceList) - 1;
+      device = std::strtoul (start, &end, 10);
+      if (end == start)
+        {
+          device = BinaryTraceRecord::NO_ID;
+        }
+    }
+}
+
+void
+BinaryTraceWriter::Write (uint8_t type, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << type << context << p);
+  BinaryTraceRecord record;
+  record.m_type = type;
+  if (context.empty ())
+    {
+      record.m_node = Simulator::GetContext ();
+      record.m_device = BinaryTraceRecord::NO_ID;
+    }
+  else
+    {
+      ParseContext (context, record.m_node, record.m_device);
+    }
+  record.m_size = p->GetSize ();
+  record.m_time = Simulator::Now ().GetNanoSeconds ();
+  record.m_uid = p->GetUid ();
+  record.m_capLen = std::min (m_snapLen, record.m_size);
+  record.m_data = 0;
+  if (record.m_capLen > 0)
+    {
+      m_packet.resize (record.m_capLen);
+      p->CopyData (&m_packet[0], record.m_capLen);
+      record.m_data = &m_packet[0];
+    }
+  Write (record);
+}
+
+void
+BinaryTraceWriter::Write (BinaryTraceRecord const &record)
+{
+  if (m_buffer.size () + BinaryTraceRecord::SIZE + record.m_capLen > BUFFER_SIZE)
+    {
+      m_os->write (reinterpret_cast<const char *> (&m_buffer[0]), m_buffer.size ());
+      m_buffer.clear ();
+    }
+  Append<uint8_t> (m_buffer, record.m_type);
+  Append<uint8_t> (m_buffer, 0);
+  Append<uint16_t> (m_buffer, record.m_capLen);
+  Append<uint32_t> (m_buffer, record.m_node);
+  Append<uint32_t> (m_buffer, record.m_device);
+  Append<uint32_t> (m_buffer, record.m_size);
+  Append<int64_t> (m_buffer, record.m_time);
+  Append<uint64_t> (m_buffer, record.m_uid);
+  if (record.m_capLen > 0)
+    {
+      m_buffer.insert (m_buffer.end (), record.m_data, record.m_data + record.m_capLen);
+    }
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_buffer.empty ())
+    {
+      m_os->write (reinterpret_cast<const char *> (&m_buffer[0]), m_buffer.size ());
+      m_buffer.clear ();
+    }
+  m_os->flush ();
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0),
+    m_snapLen (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceReader::~BinaryTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || static_cast<uint64_t> (st.st_size) < FILE_HEADER_SIZE)
+    {
+      NS_LOG_WARN ("Unable to read the header of " << filename);
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << filename);
+      return false;
+    }
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  if (Extract<uint32_t> (m_data) != BinaryTraceWriter::MAGIC
+      || Extract<uint16_t> (m_data + 4) != BinaryTraceWriter::VERSION_MAJOR)
+    {
+      NS_LOG_WARN (filename << " is not a binary trace file");
+      Close ();
+      return false;
+    }
+  m_snapLen = Extract<uint32_t> (m_data + 8);
+  m_offset = FILE_HEADER_SIZE;
+  return true;
+}
+
+void
+BinaryTraceReader::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+    }
+  m_data = 0;
+  m_size = 0;
+  m_offset = 0;
+}
+
+bool
+BinaryTraceReader::Read (BinaryTraceRecord &record)
+{
+  if (m_data == 0 || m_offset + BinaryTraceRecord::SIZE > m_size)
+    {
+      return false;
+    }
+  const uint8_t *p = m_data + m_offset;
+  record.m_type = Extract<uint8_t> (p);
+  record.m_capLen = Extract<uint16_t> (p + 2);
+  record.m_node = Extract<uint32_t> (p + 4);
+  record.m_device = Extract<uint32_t> (p + 8);
+  record.m_size = Extract<uint32_t> (p + 12);
+  record.m_time = Extract<int64_t> (p + 16);
+  record.m_uid = Extract<uint64_t> (p + 24);
+  if (m_offset + BinaryTraceRecord::SIZE + record.m_capLen > m_size)
+    {
+      NS_LOG_WARN ("Truncated record at offset " << m_offset);
+      return false;
+    }
+  record.m_data = p + BinaryTraceRecord::SIZE;
+  m_offset += BinaryTraceRecord::SIZE + record.m_capLen;
+  return true;
+}
+
+uint32_t
+BinaryTraceReader::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+} // namespace ns3
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief One record of a binary trace file
+ *
+ * A binary trace file starts with a 16 byte file header (magic number,
+ * major and minor version, snap length, reserved word) followed by the
+ * records.  Each record is a fixed 32 byte block, in the byte order of the
+ * writing host:
+ *
+ * \verbatim
+ *   0  type      uint8_t   '+', '-', 'd' or 'r', as in ascii traces
+ *   1  reserved  uint8_t
+ *   2  capLen    uint16_t  number of packet bytes following the record
+ *   4  node      uint32_t  node id (NO_ID if unknown)
+ *   8  device    uint32_t  device index (NO_ID if unknown)
+ *  12  size      uint32_t  packet size, in bytes
+ *  16  time      int64_t   simulation time, in nanoseconds
+ *  24  uid       uint64_t  packet uid
+ * \endverbatim
+ *
+ * followed by the first capLen bytes of the serialized packet, which carry
+ * the headers of the packet when a non-zero snap length is configured.
+ */
+struct BinaryTraceRecord
+{
+  static const uint32_t NO_ID = 0xffffffff;    //!< Unknown node or device
+  static const uint32_t SIZE = 32;             //!< Size of a record, without the packet bytes
+
+  uint8_t m_type;                  //!< event type
+  uint32_t m_node;                 //!< node id
+  uint32_t m_device;               //!< device index
+  uint32_t m_size;                 //!< packet size
+  int64_t m_time;                  //!< time, in nanoseconds
+  uint64_t m_uid;                  //!< packet uid
+  uint16_t m_capLen;               //!< number of captured packet bytes
+  const uint8_t *m_data;           //!< captured packet bytes, valid as long as the reader
+};
+
+/**
+ * \brief Buffered writer of binary trace records
+ *
+ * Formatting a packet with Packet::Print for an ascii trace calls the Print
+ * method of every header of the packet and produces large files.  A binary
+ * trace instead stores a fixed-size record per event, and optionally the
+ * first bytes of the packet, which can be converted back to text offline
+ * (see utils/print-binary-trace.cc).
+ *
+ * Records are accumulated in a private buffer owned by the writer, which is
+ * handed to the output stream in large chunks.  Every trace stream has its
+ * own writer, so that writers never share a buffer.
+ *
+ * \see AsciiTraceHelper::CreateBinaryFileStream
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  static const uint32_t MAGIC = 0x6e733362;          //!< Magic number of binary trace files ("ns3b")
+  static const uint16_t VERSION_MAJOR = 1;           //!< Major version of the format
+  static const uint16_t VERSION_MINOR = 0;           //!< Minor version of the format
+  static const uint32_t BUFFER_SIZE = 1 << 16;       //!< Size of the record buffer, in bytes
+
+  /**
+   * Write the file header to the stream.
+   *
+   * \param os the output stream, which must outlive the writer
+   * \param snapLen maximum number of packet bytes to store with each record
+   */
+  BinaryTraceWriter (std::ostream *os, uint32_t snapLen);
+  /**
+   * Flush the buffered records.
+   */
+  ~BinaryTraceWriter ();
+
+  /**
+   * \brief Write a record for an event occurring now
+   *
+   * The node and device are extracted from the context when it is a
+   * "/NodeList/[i]/DeviceList/[j]/..." config path.  When no context is
+   * available, the node is the context of the current simulator event.
+   *
+   * \param type the event type
+   * \param context the trace context, possibly empty
+   * \param p the packet
+   */
+  void Write (uint8_t type, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a record
+   * \param record the record
+   */
+  void Write (BinaryTraceRecord const &record);
+
+  /**
+   * \brief Hand the buffered records to the output stream, and flush it.
+   */
+  void Flush (void);
+
+  /**
+   * \returns the snap length
+   */
+  uint32_t GetSnapLen (void) const;
+
+private:
+  /**
+   * \brief Extract the node and device ids from a config path
+   * \param context the config path
+   * \param node [out] node id
+   * \param device [out] device index
+   */
+  static void ParseContext (std::string const &context, uint32_t &node, uint32_t &device);
+
+  std::ostream *m_os;              //!< output stream
+  uint32_t m_snapLen;              //!< maximum number of packet bytes per record
+  std::vector<uint8_t> m_buffer;   //!< buffered records
+  std::vector<uint8_t> m_packet;   //!< scratch space for packet bytes
+};
+
+/**
+ * \brief Reader of binary trace files
+ *
+ * The file is mapped in memory, so that records are decoded in place
+ * without copying the file.
+ */
+class BinaryTraceReader
+{
+public:
+  BinaryTraceReader ();
+  ~BinaryTraceReader ();
+
+  /**
+   * \brief Map a binary trace file in memory and check its header
+   * \param filename file name
+   * \returns true on success
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Unmap the file
+   */
+  void Close (void);
+
+  /**
+   * \brief Decode the next record
+   * \param record [out] the record
+   * \returns false at the end of the file or if the file is truncated
+   */
+  bool Read (BinaryTraceRecord &record);
+
+  /**
+   * \returns the snap length the file was written with
+   */
+  uint32_t GetSnapLen (void) const;
+
+private:
+  /**
+   * \brief Copy constructor: not implemented
+   * \param o object to copy
+   */
+  BinaryTraceReader (const BinaryTraceReader &o);
+  /**
+   * \brief Assignment operator: not implemented
+   * \param o object to copy
+   * \returns a reference to this object
+   */
+  BinaryTraceReader &operator = (const BinaryTraceReader &o);
+
+  const uint8_t *m_data;           //!< mapped file
+  uint64_t m_size;                 //!< size of the mapped file
+  uint64_t m_offset;               //!< offset of the next record
+  uint32_t m_snapLen;              //!< snap length
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_H */
@@ -49,6 +49,8 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
+  // the writer flushes its buffered records to the stream
+  m_binaryWriter = 0;
   FatalImpl::UnregisterStream (m_ostream);
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
@@ -61,4 +63,17 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+void
+OutputStreamWrapper::SetBinaryFormat (uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << snapLen);
+  m_binaryWriter = Create<BinaryTraceWriter> (m_ostream, snapLen);
+}
+
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryTraceWriter (void) const
+{
+  return m_binaryWriter;
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace.h"
 
 namespace ns3 {
 
@@ -92,9 +93,25 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Make the trace sinks writing to this stream store binary trace records
+   * rather than text.  Must be called before anything is written to the
+   * stream, which should have been opened in binary mode.
+   *
+   * \param snapLen maximum number of packet bytes to store with each record
+   */
+  void SetBinaryFormat (uint32_t snapLen);
+
+  /**
+   * \returns the binary trace writer of this stream, or 0 if text should
+   * be written to the stream.
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTraceWriter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceWriter> m_binaryWriter; //!< Binary trace writer, if any
 };
 
 } // namespace ns3
@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/buffer.h"
@@ -52,6 +53,9 @@ PcapFileWrapper::GetTypeId (void)
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngFile (0),
+    m_ngInterface (0),
+    m_ngDataLinkType (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +70,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -115,10 +123,30 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     } 
 }
 
+void
+PcapFileWrapper::Init (Ptr<PcapNgFile> file, uint32_t dataLinkType,
+                       std::string const &name, std::string const &comment, uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << file << dataLinkType << name << comment << snapLen);
+  NS_ASSERT (file != 0);
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
+    {
+      snapLen = m_snapLen;
+    }
+  m_ngFile = file;
+  m_ngDataLinkType = dataLinkType;
+  m_ngInterface = m_ngFile->AddInterface (dataLinkType, snapLen, name, comment);
+}
+
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +167,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +192,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile)
+    {
+      m_ngFile->Write (m_ngInterface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -178,6 +216,7 @@ PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 Ptr<Packet> 
 PcapFileWrapper::Read (Time &t)
 {
+  NS_ABORT_MSG_IF (m_ngFile, "PcapFileWrapper::Read(): not supported on a pcapng interface");
   uint32_t tsSec;
   uint32_t tsUsec;
   uint32_t inclLen;
@@ -246,6 +285,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_snapLen;
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -253,6 +296,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile)
+    {
+      return m_ngDataLinkType;
+    }
   return m_file.GetDataLinkType ();
 }
 
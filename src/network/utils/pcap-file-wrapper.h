@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -109,6 +110,26 @@ public:
              uint32_t snapLen = std::numeric_limits<uint32_t>::max (), 
              int32_t tzCorrection = PcapFile::ZONE_DEFAULT);
 
+  /**
+   * Initialize this wrapper as one interface of a shared pcapng file instead
+   * of a pcap file of its own.  The wrapper must not have been opened.  All
+   * subsequent Write operations are directed to the pcapng file, tagged with
+   * the identifier of the interface added by this method; Read is not
+   * supported.
+   *
+   * \param file The shared pcapng file.
+   * \param dataLinkType A data link type as defined in the pcap library.
+   * \param name The name of the interface in the pcapng file.
+   * \param comment A comment describing the interface (may be empty).
+   * \param snapLen An optional maximum size for packets written to the file.
+   * If not provided, the "CaptureSize" attribute is used.
+   */
+  void Init (Ptr<PcapNgFile> file,
+             uint32_t dataLinkType,
+             std::string const &name,
+             std::string const &comment,
+             uint32_t snapLen = std::numeric_limits<uint32_t>::max ());
+
   /**
    * \brief Write the next packet to file
    * 
@@ -224,6 +245,9 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  Ptr<PcapNgFile> m_ngFile; //!< Shared pcapng file, if any
+  uint32_t m_ngInterface; //!< Interface identifier in the shared pcapng file
+  uint32_t m_ngDataLinkType; //!< Data link type of the pcapng interface
 };
 
 } // namespace ns3
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/log.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;   /**< Section Header Block type */
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;     /**< Interface Description Block type */
+const uint32_t ENHANCED_PACKET_BLOCK = 6;           /**< Enhanced Packet Block type */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;       /**< Byte order magic of the Section Header Block */
+
+const uint16_t OPT_ENDOFOPT = 0;                    /**< End of options */
+const uint16_t OPT_COMMENT = 1;                     /**< Comment option */
+const uint16_t IF_NAME = 2;                         /**< Interface name option */
+const uint16_t IF_TSRESOL = 9;                      /**< Interface timestamp resolution option */
+
+/**
+ * \brief Round a length up to the next 32-bit boundary
+ * \param length the length
+ * \returns the padded length
+ */
+static uint32_t
+Pad4 (uint32_t length)
+{
+  return (length + 3) & ~3U;
+}
+
+/**
+ * \brief Size of an option with its header and padding
+ * \param value the option value
+ * \returns the size of the option in the block
+ */
+static uint32_t
+OptionSize (std::string const &value)
+{
+  return value.empty () ? 0 : 4 + Pad4 (value.size ());
+}
+
+PcapNgFile::PcapNgFile (uint32_t bufferSize)
+  : m_buffer (bufferSize)
+{
+  NS_LOG_FUNCTION (this << bufferSize);
+  FatalImpl::RegisterStream (&m_file);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.fail ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT (!m_file.is_open ());
+
+  m_filename = filename;
+  //
+  // The stream buffer must be installed before the file is opened for the
+  // library to honor it.
+  //
+  if (!m_buffer.empty ())
+    {
+      m_file.rdbuf ()->pubsetbuf (&m_buffer[0], m_buffer.size ());
+    }
+  m_file.open (filename.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  if (m_file.fail ())
+    {
+      return;
+    }
+
+  //
+  // Section Header Block: type, length, byte order magic, version 1.0,
+  // unknown section length, no options, length.
+  //
+  uint32_t blockLen = 28;
+  Write32 (SECTION_HEADER_BLOCK);
+  Write32 (blockLen);
+  Write32 (BYTE_ORDER_MAGIC);
+  Write16 (1);
+  Write16 (0);
+  Write32 (0xffffffff);
+  Write32 (0xffffffff);
+  Write32 (blockLen);
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+}
+
+std::string
+PcapNgFile::GetFilename (void) const
+{
+  return m_filename;
+}
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                          std::string const &name, std::string const &comment)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name << comment);
+  NS_ASSERT (m_file.good ());
+
+  std::string tsresol (1, 9); // 10^-9 seconds
+  uint32_t optionsLen = OptionSize (name) + OptionSize (comment) + OptionSize (tsresol) + 4;
+  uint32_t blockLen = 20 + optionsLen;
+
+  Write32 (INTERFACE_DESCRIPTION_BLOCK);
+  Write32 (blockLen);
+  Write16 (dataLinkType);
+  Write16 (0);
+  Write32 (snapLen);
+  WriteOption (IF_NAME, name);
+  WriteOption (OPT_COMMENT, comment);
+  WriteOption (IF_TSRESOL, tsresol);
+  Write16 (OPT_ENDOFOPT);
+  Write16 (0);
+  Write32 (blockLen);
+
+  m_snapLen.push_back (snapLen);
+  return m_snapLen.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_snapLen.size ();
+}
+
+uint32_t
+PcapNgFile::WritePacketBlockHeader (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << totalLen);
+  NS_ASSERT (m_file.good ());
+  NS_ASSERT_MSG (interfaceId < m_snapLen.size (), "Unknown pcapng interface " << interfaceId);
+
+  uint32_t inclLen = std::min (totalLen, m_snapLen[interfaceId]);
+  uint32_t blockLen = 32 + Pad4 (inclLen);
+
+  Write32 (ENHANCED_PACKET_BLOCK);
+  Write32 (blockLen);
+  Write32 (interfaceId);
+  Write32 (static_cast<uint32_t> (tsNs >> 32));
+  Write32 (static_cast<uint32_t> (tsNs & 0xffffffff));
+  Write32 (inclLen);
+  Write32 (totalLen);
+  return inclLen;
+}
+
+void
+PcapNgFile::WritePacketBlockTrailer (uint32_t inclLen)
+{
+  WritePadding (inclLen);
+  Write32 (32 + Pad4 (inclLen));
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const * const data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &data << totalLen);
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, tsNs, totalLen);
+  m_file.write ((const char *)data, inclLen);
+  WritePacketBlockTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << p);
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, tsNs, p->GetSize ());
+  p->CopyData (&m_file, inclLen);
+  WritePacketBlockTrailer (inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t totalSize = headerSize + p->GetSize ();
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, tsNs, totalSize);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (&m_file, toCopy);
+  p->CopyData (&m_file, inclLen - toCopy);
+  WritePacketBlockTrailer (inclLen);
+}
+
+void
+PcapNgFile::WriteOption (uint16_t code, std::string const &value)
+{
+  if (value.empty ())
+    {
+      return;
+    }
+  Write16 (code);
+  Write16 (value.size ());
+  m_file.write (value.data (), value.size ());
+  WritePadding (value.size ());
+}
+
+void
+PcapNgFile::WritePadding (uint32_t length)
+{
+  static const char zeros[4] = { 0, 0, 0, 0 };
+  m_file.write (zeros, Pad4 (length) - length);
+}
+
+void
+PcapNgFile::Write32 (uint32_t val)
+{
+  m_file.write ((const char *)&val, sizeof (val));
+}
+
+void
+PcapNgFile::Write16 (uint16_t val)
+{
+  m_file.write ((const char *)&val, sizeof (val));
+}
+
+} // namespace ns3
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A write-only pcapng file holding the captures of many interfaces
+ *
+ * Classic pcap files carry a single data link type in their global header,
+ * so every traced device needs its own file.  The pcapng format instead
+ * describes each capture interface with an Interface Description Block and
+ * tags every Enhanced Packet Block with the index of its interface, which
+ * allows all the devices of a simulation to share one file (and one file
+ * descriptor).
+ *
+ * The file is written through a single, large, stream buffer; the buffer is
+ * only flushed when it is full or when the file is closed.  Timestamps are
+ * always stored with nanosecond resolution.
+ *
+ * See https://github.com/pcapng/pcapng
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  static const uint32_t SNAPLEN_DEFAULT = 65535;       //!< Default value for maximum octets to save per packet
+  static const uint32_t BUFFER_SIZE_DEFAULT = 1 << 20; //!< Default size of the stream buffer, in bytes
+
+  /**
+   * \param bufferSize the size of the stream buffer, in bytes
+   */
+  PcapNgFile (uint32_t bufferSize = BUFFER_SIZE_DEFAULT);
+  ~PcapNgFile ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file, truncating any existing file with the same
+   * name, and write the Section Header Block.
+   *
+   * \param filename String containing the name of the file.
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * Flush the stream buffer and close the underlying file.
+   */
+  void Close (void);
+
+  /**
+   * \return the name of the file
+   */
+  std::string GetFilename (void) const;
+
+  /**
+   * \brief Append an Interface Description Block to the file
+   *
+   * \param dataLinkType A data link type as defined in the pcap library
+   * \param snapLen Maximum size of the packets stored for this interface
+   * \param name Interface name (if_name option); omitted if empty
+   * \param comment Free text comment (opt_comment option); omitted if empty
+   * \returns the interface identifier to be used when writing packets
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen,
+                         std::string const &name, std::string const &comment);
+
+  /**
+   * \returns the number of interfaces described in the file
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \brief Write an Enhanced Packet Block
+   *
+   * \param interfaceId Interface identifier returned by AddInterface
+   * \param tsNs Packet timestamp, nanoseconds
+   * \param data Data buffer
+   * \param totalLen Total packet length
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const * const data, uint32_t totalLen);
+
+  /**
+   * \brief Write an Enhanced Packet Block
+   *
+   * \param interfaceId Interface identifier returned by AddInterface
+   * \param tsNs Packet timestamp, nanoseconds
+   * \param p Packet to write
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p);
+
+  /**
+   * \brief Write an Enhanced Packet Block
+   *
+   * \param interfaceId Interface identifier returned by AddInterface
+   * \param tsNs Packet timestamp, nanoseconds
+   * \param header Header to write, in front of packet
+   * \param p Packet to write
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p);
+
+private:
+  /**
+   * \brief Write the header of an Enhanced Packet Block
+   *
+   * \param interfaceId Interface identifier
+   * \param tsNs Packet timestamp, nanoseconds
+   * \param totalLen total packet length
+   * \returns the length of the packet data to write in the block
+   */
+  uint32_t WritePacketBlockHeader (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen);
+  /**
+   * \brief Write the padding and the trailer of an Enhanced Packet Block
+   *
+   * \param inclLen the length of the packet data written in the block
+   */
+  void WritePacketBlockTrailer (uint32_t inclLen);
+  /**
+   * \brief Write a block option, including its padding
+   * \param code option code
+   * \param value option value
+   */
+  void WriteOption (uint16_t code, std::string const &value);
+  /**
+   * \brief Write zero bytes up to the next 32-bit boundary
+   * \param length the length of the data just written
+   */
+  void WritePadding (uint32_t length);
+  /**
+   * \brief Write a 32-bit value in host byte order
+   * \param val the value
+   */
+  void Write32 (uint32_t val);
+  /**
+   * \brief Write a 16-bit value in host byte order
+   * \param val the value
+   */
+  void Write16 (uint16_t val);
+
+  std::string m_filename;              //!< file name
+  std::ofstream m_file;                //!< file stream
+  std::vector<char> m_buffer;          //!< stream buffer
+  std::vector<uint32_t> m_snapLen;     //!< snap length of each interface
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
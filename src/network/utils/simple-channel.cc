@@ -22,6 +22,7 @@
 #include "simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 
@@ -77,6 +78,32 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
     }
 }
 
+void
+SimpleChannel::SendBurst (Ptr<PacketBurst> burst, uint16_t protocol,
+                          Mac48Address to, Mac48Address from,
+                          Ptr<SimpleNetDevice> sender, Time lastTxStart)
+{
+  NS_LOG_FUNCTION (this << burst << protocol << to << from << sender << lastTxStart);
+  for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
+    {
+      Ptr<SimpleNetDevice> tmp = *i;
+      if (tmp == sender)
+        {
+          continue;
+        }
+      if (m_blackListedDevices.find (tmp) != m_blackListedDevices.end ())
+        {
+          if (find (m_blackListedDevices[tmp].begin (), m_blackListedDevices[tmp].end (), sender) !=
+              m_blackListedDevices[tmp].end () )
+            {
+              continue;
+            }
+        }
+      Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), lastTxStart + m_delay,
+                                      &SimpleNetDevice::ReceiveBurst, tmp, burst->Copy (), protocol, to, from);
+    }
+}
+
 void
 SimpleChannel::Add (Ptr<SimpleNetDevice> device)
 {
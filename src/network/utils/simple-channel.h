@@ -30,6 +30,7 @@ namespace ns3 {
 
 class SimpleNetDevice;
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup channel
@@ -68,6 +69,23 @@ public:
   virtual void Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
                      Ptr<SimpleNetDevice> sender);
 
+  /**
+   * Back-to-back packets are sent by a net device.  A single receive
+   * event is scheduled for all net devices connected to the channel
+   * other than the net device who sent the packets, when the last
+   * packet of the burst is received.
+   *
+   * \param burst packets to be sent
+   * \param protocol protocol number
+   * \param to address to send packets to
+   * \param from address the packets are coming from
+   * \param sender netdevice who sent the packets
+   * \param lastTxStart time, relative to now, at which the last packet
+   *        of the burst starts being sent
+   */
+  virtual void SendBurst (Ptr<PacketBurst> burst, uint16_t protocol, Mac48Address to, Mac48Address from,
+                          Ptr<SimpleNetDevice> sender, Time lastTxStart);
+
   /**
    * Attached a net device to the channel.
    *
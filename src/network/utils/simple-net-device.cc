@@ -21,6 +21,7 @@
 #include "simple-channel.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/error-model.h"
@@ -304,6 +305,17 @@ SimpleNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol,
     }
 }
 
+void
+SimpleNetDevice::ReceiveBurst (Ptr<PacketBurst> burst, uint16_t protocol,
+                               Mac48Address to, Mac48Address from)
+{
+  NS_LOG_FUNCTION (this << burst << protocol << to << from);
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      Receive (*i, protocol, to, from);
+    }
+}
+
 void 
 SimpleNetDevice::SetChannel (Ptr<SimpleChannel> channel)
 {
@@ -500,6 +512,44 @@ SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address&
   return true;
 }
 
+bool
+SimpleNetDevice::SendBurst (Ptr<PacketBurst> burst, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << burst << dest << protocolNumber);
+  if (m_queue->GetNPackets () > 0 || TransmitCompleteEvent.IsRunning ())
+    {
+      return NetDevice::SendBurst (burst, dest, protocolNumber);
+    }
+
+  Mac48Address to = Mac48Address::ConvertFrom (dest);
+  bool ret = true;
+  Ptr<PacketBurst> accepted = Create<PacketBurst> ();
+  Time txStart = Time (0);
+  Time lastTxStart = Time (0);
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      if ((*i)->GetSize () > GetMtu ())
+        {
+          ret = false;
+          continue;
+        }
+      accepted->AddPacket (*i);
+      lastTxStart = txStart;
+      if (m_bps > DataRate (0))
+        {
+          txStart += m_bps.CalculateBytesTxTime ((*i)->GetSize ());
+        }
+    }
+  if (accepted->GetNPackets () == 0)
+    {
+      return ret;
+    }
+
+  m_channel->SendBurst (accepted, protocolNumber, to, m_address, this, lastTxStart);
+  TransmitCompleteEvent = Simulator::Schedule (txStart, &SimpleNetDevice::TransmitComplete, this);
+  return ret;
+}
+
 
 void
 SimpleNetDevice::TransmitComplete ()
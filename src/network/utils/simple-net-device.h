@@ -73,6 +73,17 @@ public:
    * \param from address packet was sent from
    */
   void Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
+
+  /**
+   * Receive back-to-back packets from a connected SimpleChannel.  Each
+   * packet is processed as if it had been passed to Receive.
+   *
+   * \param burst Packets received on the channel
+   * \param protocol protocol number
+   * \param to address packets should be sent to
+   * \param from address packets were sent from
+   */
+  void ReceiveBurst (Ptr<PacketBurst> burst, uint16_t protocol, Mac48Address to, Mac48Address from);
   
   /**
    * Attach a channel to this net device.  This will be the 
@@ -126,6 +137,18 @@ public:
   virtual bool IsBridge (void) const;
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  /**
+   * If the device is idle, the packets are handed to the channel at once,
+   * which delivers them with a single receive event, and a single transmit
+   * completion event is scheduled for the burst.  Otherwise, the packets
+   * are sent one by one.
+   *
+   * \param burst the packets to send
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber the type of payload contained in the packets
+   * \return whether all the packets were accepted by the device
+   */
+  virtual bool SendBurst (Ptr<PacketBurst> burst, const Address& dest, uint16_t protocolNumber);
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
   virtual bool NeedsArp (void) const;
@@ -20,6 +20,7 @@
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 
@@ -106,6 +107,34 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointChannel::TransmitStartBurst (
+  Ptr<PacketBurst> burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &txTimes)
+{
+  NS_LOG_FUNCTION (this << burst << src);
+  NS_ASSERT (txTimes.size () == burst->GetNPackets ());
+  NS_ASSERT (!txTimes.empty ());
+
+  NS_ASSERT (m_link[0].m_state != INITIALIZING);
+  NS_ASSERT (m_link[1].m_state != INITIALIZING);
+
+  uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                  txTimes.back () + m_delay, &PointToPointNetDevice::ReceiveBurst,
+                                  m_link[wire].m_dst, burst);
+
+  // Call the tx anim callback on the net device, once per packet
+  std::vector<Time>::const_iterator txTime = txTimes.begin ();
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++txTime)
+    {
+      m_txrxPointToPoint (*i, src, m_link[wire].m_dst, *txTime, *txTime + m_delay);
+    }
+  return true;
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
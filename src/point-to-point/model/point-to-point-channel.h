@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class PointToPointNetDevice;
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup point-to-point
@@ -80,6 +82,24 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Transmit back-to-back packets over this channel
+   *
+   * The packets of the burst are delivered to the destination by a single
+   * receive event, scheduled when the last bit of the last packet arrives.
+   * The packets at the head of the burst are thus received a little later
+   * than if they had been sent one by one, by at most the transmission time
+   * of the burst.
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTimes For each packet of the burst, the time (relative to now)
+   *        at which its last bit is transmitted
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitStartBurst (Ptr<PacketBurst> burst, Ptr<PointToPointNetDevice> src,
+                                   std::vector<Time> const &txTimes);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
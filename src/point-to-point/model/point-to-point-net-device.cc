@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <vector>
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -26,6 +27,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -68,6 +70,15 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("MaxBurstSize",
+                   "The maximum number of queued packets transmitted back to back with "
+                   "a single transmit completion event and a single receive event at the "
+                   "peer.  Values larger than 1 speed up the simulation of saturated "
+                   "high rate links, at the cost of delivering the packets of a burst "
+                   "together when the last one arrives.  1 disables this mode.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_maxBurstSize),
+                   MakeUintegerChecker<uint32_t> (1))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -249,6 +260,7 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_currentBurst = 0;
   m_queue = 0;
   m_queueInterface = 0;
   NetDevice::DoDispose ();
@@ -298,6 +310,64 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+bool
+PointToPointNetDevice::TransmitStartBurst (uint32_t maxPackets)
+{
+  NS_LOG_FUNCTION (this << maxPackets);
+
+  //
+  // This function is called to start the transmission of back-to-back
+  // packets.  The packets are dequeued now, and a single event is scheduled
+  // for the time at which the transmission of the whole burst is complete.
+  //
+  NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
+
+  Ptr<PacketBurst> burst = Create<PacketBurst> ();
+  std::vector<Time> txTimes;
+  txTimes.reserve (maxPackets);
+  Time txEnd = Seconds (0);
+  for (uint32_t n = 0; n < maxPackets; ++n)
+    {
+      Ptr<Packet> p = m_queue->Dequeue ();
+      if (p == 0)
+        {
+          break;
+        }
+      m_snifferTrace (p);
+      m_promiscSnifferTrace (p);
+      m_phyTxBeginTrace (p);
+      if (n > 0)
+        {
+          txEnd += m_tInterframeGap;
+        }
+      txEnd += m_bps.CalculateBytesTxTime (p->GetSize ());
+      txTimes.push_back (txEnd);
+      burst->AddPacket (p);
+    }
+  if (txTimes.empty ())
+    {
+      return true;
+    }
+
+  m_txMachineState = BUSY;
+  m_currentBurst = burst;
+
+  Time txCompleteTime = txEnd + m_tInterframeGap;
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent for " << txTimes.size () << " packets in " << txCompleteTime.GetSeconds () << "sec");
+  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+
+  bool result = m_channel->TransmitStartBurst (burst, this, txTimes);
+  if (result == false)
+    {
+      for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+        {
+          m_phyTxDropTrace (*i);
+        }
+    }
+  return result;
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -312,11 +382,31 @@ PointToPointNetDevice::TransmitComplete (void)
   NS_ASSERT_MSG (m_txMachineState == BUSY, "Must be BUSY if transmitting");
   m_txMachineState = READY;
 
-  NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
+  NS_ASSERT_MSG (m_currentPkt != 0 || m_currentBurst != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
+  if (m_currentBurst != 0)
+    {
+      for (std::list<Ptr<Packet> >::const_iterator i = m_currentBurst->Begin (); i != m_currentBurst->End (); ++i)
+        {
+          m_phyTxEndTrace (*i);
+        }
+      m_currentBurst = 0;
+    }
+  else
+    {
+      m_phyTxEndTrace (m_currentPkt);
+    }
   m_currentPkt = 0;
 
+  //
+  // In high rate mode, transmit the backlog of the queue in bursts.
+  //
+  if (m_maxBurstSize > 1 && m_queue->GetNPackets () > 1)
+    {
+      TransmitStartBurst (m_maxBurstSize);
+      return;
+    }
+
   Ptr<Packet> p = m_queue->Dequeue ();
   if (p == 0)
     {
@@ -414,6 +504,16 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveBurst (Ptr<PacketBurst> burst)
+{
+  NS_LOG_FUNCTION (this << burst);
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      Receive (*i);
+    }
+}
+
 Ptr<Queue<Packet> >
 PointToPointNetDevice::GetQueue (void) const
 { 
@@ -592,6 +692,55 @@ PointToPointNetDevice::Send (
   return false;
 }
 
+bool
+PointToPointNetDevice::SendBurst (
+  Ptr<PacketBurst> burst,
+  const Address &dest,
+  uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << burst << dest << protocolNumber);
+
+  if (IsLinkUp () == false)
+    {
+      for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+        {
+          m_macTxDropTrace (*i);
+        }
+      return false;
+    }
+
+  //
+  // Enqueue all the packets first, so that they can be dequeued and put on
+  // the wire together if the transmitter is idle.
+  //
+  bool ret = true;
+  uint32_t nEnqueued = 0;
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      AddHeader (packet, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet))
+        {
+          ++nEnqueued;
+        }
+      else
+        {
+          m_macTxDropTrace (packet);
+          ret = false;
+        }
+    }
+
+  if (nEnqueued > 0 && m_txMachineState == READY)
+    {
+      if (!TransmitStartBurst (nEnqueued))
+        {
+          ret = false;
+        }
+    }
+  return ret;
+}
+
 bool
 PointToPointNetDevice::SendFrom (Ptr<Packet> packet, 
                                  const Address &source, 
@@ -37,6 +37,7 @@ template <typename Item> class Queue;
 class NetDeviceQueueInterface;
 class PointToPointChannel;
 class ErrorModel;
+class PacketBurst;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -150,6 +151,17 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * Receive back-to-back packets from a connected PointToPointChannel.
+   *
+   * This is the public method used by the channel to indicate that the
+   * last bit of the last packet of a burst has arrived at the device.
+   * Each packet is processed as if it had been passed to Receive.
+   *
+   * \param burst Ptr to the received packets.
+   */
+  void ReceiveBurst (Ptr<PacketBurst> burst);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -179,6 +191,22 @@ public:
   virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
 
+  /**
+   * \brief Send back-to-back packets
+   *
+   * The packets are enqueued in order.  If the transmitter is idle, they
+   * are then put on the wire as a single transmission: one transmit
+   * completion event is scheduled for the whole burst, and the channel
+   * delivers the burst to the peer with a single receive event, when the
+   * last bit of the last packet arrives.
+   *
+   * \param burst the packets to send
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber the type of payload contained in the packets
+   * \return whether all the packets were accepted by the device
+   */
+  virtual bool SendBurst (Ptr<PacketBurst> burst, const Address &dest, uint16_t protocolNumber);
+
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
 
@@ -271,6 +299,20 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Start Sending back-to-back Packets Down the Wire.
+   *
+   * Dequeue up to the given number of packets and start transmitting them
+   * as a single burst.  A single TransmitComplete event is scheduled at the
+   * end of the interframe gap following the last packet.
+   *
+   * \see PointToPointChannel::TransmitStartBurst ()
+   * \see TransmitComplete()
+   * \param maxPackets the maximum number of packets to dequeue
+   * \returns true if success, false on failure
+   */
+  bool TransmitStartBurst (uint32_t maxPackets);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -311,6 +353,12 @@ private:
    */
   Time           m_tInterframeGap;
 
+  /**
+   * The maximum number of queued packets the Net Device transmits as a
+   * single burst
+   */
+  uint32_t       m_maxBurstSize;
+
   /**
    * The PointToPointChannel to which this PointToPointNetDevice has been
    * attached.
@@ -461,6 +509,7 @@ private:
   uint32_t m_mtu;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  Ptr<PacketBurst> m_currentBurst; //!< Current burst processed, if any
 
   /**
    * \brief PPP to Ethernet protocol number mapping
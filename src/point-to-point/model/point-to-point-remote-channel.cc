@@ -23,6 +23,7 @@
 #include "point-to-point-remote-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
@@ -77,4 +78,21 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitStartBurst (
+  Ptr<PacketBurst> burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &txTimes)
+{
+  NS_LOG_FUNCTION (this << burst << src);
+  NS_ASSERT (txTimes.size () == burst->GetNPackets ());
+
+  std::vector<Time>::const_iterator txTime = txTimes.begin ();
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++txTime)
+    {
+      TransmitStart (*i, src, *txTime);
+    }
+  return true;
+}
+
 } // namespace ns3
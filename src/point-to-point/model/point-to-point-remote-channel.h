@@ -68,6 +68,21 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Transmit back-to-back packets
+   *
+   * Every packet is sent with its own MPI message, so that the remote
+   * simulator receives each of them at its exact arrival time.
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTimes For each packet of the burst, the time (relative to now)
+   *        at which its last bit is transmitted
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitStartBurst (Ptr<PacketBurst> burst, Ptr<PointToPointNetDevice> src,
+                                   std::vector<Time> const &txTimes);
 };
 
 } // namespace ns3
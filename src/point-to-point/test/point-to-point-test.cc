@@ -24,6 +24,9 @@
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
+#include "ns3/data-rate.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -101,6 +104,238 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the burst path of the PointToPoint model
+ *
+ * It sends a burst of packets from one NetDevice to another, over a
+ * PointToPointChannel, and checks that they are all received when the
+ * last bit of the last packet arrives.
+ */
+class PointToPointBurstTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBurstTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a burst of packets to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendBurst (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Receive callback
+   *
+   * \param device the receiving NetDevice
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  /**
+   * \brief PhyTxEnd trace sink
+   *
+   * \param p the packet
+   */
+  void PhyTxEnd (Ptr<const Packet> p);
+
+  std::vector<Time> m_rxTimes;    //!< Receive times
+  uint32_t m_nTxEnd;              //!< Number of PhyTxEnd events
+};
+
+PointToPointBurstTest::PointToPointBurstTest ()
+  : TestCase ("PointToPoint burst"),
+    m_nTxEnd (0)
+{
+}
+
+void
+PointToPointBurstTest::SendBurst (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<PacketBurst> burst = CreateObject<PacketBurst> ();
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      // 998 bytes of payload and a 2 byte PPP header
+      burst->AddPacket (Create<Packet> (998));
+    }
+  bool ret = device->SendBurst (burst, device->GetBroadcast (), 0x800);
+  NS_TEST_EXPECT_MSG_EQ (ret, true, "SendBurst failed");
+}
+
+bool
+PointToPointBurstTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 998, "Wrong packet size");
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointBurstTest::PhyTxEnd (Ptr<const Packet> p)
+{
+  m_nTxEnd++;
+}
+
+void
+PointToPointBurstTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+
+  // 1000 byte frames take 1 ms to transmit
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBurstTest::Receive, this));
+  devA->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&PointToPointBurstTest::PhyTxEnd, this));
+
+  // the second burst is sent while the first one is in flight
+  Simulator::Schedule (Seconds (1.0), &PointToPointBurstTest::SendBurst, this, devA);
+  Simulator::Schedule (MicroSeconds (1000500), &PointToPointBurstTest::SendBurst, this, devA);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 6, "Wrong number of received packets");
+  NS_TEST_EXPECT_MSG_EQ (m_nTxEnd, 6, "Wrong number of PhyTxEnd events");
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_rxTimes[i], MilliSeconds (1004), "Packet " << i << " of the burst not received with the last one");
+    }
+  for (uint32_t i = 3; i < 6; ++i)
+    {
+      // queued while busy, then sent one by one
+      NS_TEST_EXPECT_MSG_EQ (m_rxTimes[i], MilliSeconds (1002 + i), "Packet " << i << " received at the wrong time");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the MaxBurstSize attribute of the PointToPoint model
+ *
+ * It fills the queue of a device with MaxBurstSize set, and checks that
+ * the backlog is transmitted in bursts.
+ */
+class PointToPointMaxBurstSizeTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMaxBurstSizeTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param n number of packets
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+
+  /**
+   * \brief Receive callback
+   *
+   * \param device the receiving NetDevice
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::vector<Time> m_rxTimes;    //!< Receive times
+};
+
+PointToPointMaxBurstSizeTest::PointToPointMaxBurstSizeTest ()
+  : TestCase ("PointToPoint MaxBurstSize")
+{
+}
+
+void
+PointToPointMaxBurstSizeTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      device->Send (Create<Packet> (998), device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointMaxBurstSizeTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointMaxBurstSizeTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+
+  // 1000 byte frames take 1 ms to transmit
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->SetAttribute ("MaxBurstSize", UintegerValue (4));
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue<Packet> > ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&PointToPointMaxBurstSizeTest::Receive, this));
+
+  Simulator::Schedule (Seconds (1.0), &PointToPointMaxBurstSizeTest::SendPackets, this, devA, 6);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the first packet is sent alone, then a burst of four packets, then the last one
+  Time expected[6] = { MilliSeconds (1002), MilliSeconds (1006), MilliSeconds (1006),
+                       MilliSeconds (1006), MilliSeconds (1006), MilliSeconds (1007) };
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 6, "Wrong number of received packets");
+  for (uint32_t i = 0; i < 6; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_rxTimes[i], expected[i], "Packet " << i << " received at the wrong time");
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -117,6 +352,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBurstTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMaxBurstSizeTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/system-mutex.h"
+#include "ns3/random-variable-stream.h"
+#include "fading-trace.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FadingTrace");
+
+FadingTrace::FadingTrace ()
+  : m_nRows (0),
+    m_nSamples (0),
+    m_values (0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FadingTrace::FadingTrace (uint32_t nRows, uint32_t nSamples, Time samplePeriod)
+  : m_nRows (nRows),
+    m_nSamples (nSamples),
+    m_samplePeriod (samplePeriod),
+    m_data (static_cast<uint64_t> (nRows) * nSamples, 0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this << nRows << nSamples << samplePeriod);
+  NS_ASSERT_MSG (nRows > 0 && nSamples > 0, "A fading trace must not be empty");
+  NS_ASSERT_MSG (samplePeriod.IsStrictlyPositive (), "The sample period must be positive");
+  m_values = &m_data[0];
+}
+
+FadingTrace::~FadingTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+}
+
+Ptr<FadingTrace>
+FadingTrace::Generate (uint32_t nRows, uint32_t nSamples, Time samplePeriod,
+                       double dopplerHz, uint32_t nOscillators,
+                       Ptr<UniformRandomVariable> uniform)
+{
+  NS_LOG_FUNCTION (nRows << nSamples << samplePeriod << dopplerHz << nOscillators << uniform);
+  NS_ASSERT (nOscillators > 0);
+  Ptr<FadingTrace> trace = Create<FadingTrace> (nRows, nSamples, samplePeriod);
+  std::vector<double> frequencies (nOscillators);
+  std::vector<double> phases (nOscillators);
+  double period = samplePeriod.GetSeconds ();
+  for (uint32_t row = 0; row < nRows; ++row)
+    {
+      for (uint32_t k = 0; k < nOscillators; ++k)
+        {
+          // Doppler shift of a random angle of arrival
+          frequencies[k] = 2 * M_PI * dopplerHz * std::cos (2 * M_PI * uniform->GetValue ());
+          phases[k] = 2 * M_PI * uniform->GetValue ();
+        }
+      double *values = &trace->m_data[static_cast<uint64_t> (row) * nSamples];
+      for (uint32_t sample = 0; sample < nSamples; ++sample)
+        {
+          double t = sample * period;
+          double re = 0;
+          double im = 0;
+          for (uint32_t k = 0; k < nOscillators; ++k)
+            {
+              re += std::cos (frequencies[k] * t + phases[k]);
+              im += std::sin (frequencies[k] * t + phases[k]);
+            }
+          values[sample] = 10 * std::log10 ((re * re + im * im) / nOscillators);
+        }
+    }
+  return trace;
+}
+
+Ptr<const FadingTrace>
+FadingTrace::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  // the traces stay mapped until the end of the program
+  typedef std::map<std::string, Ptr<const FadingTrace> > TraceMap;
+  static SystemMutex mutex;
+  static TraceMap traces;
+
+  CriticalSection cs (mutex);
+  TraceMap::const_iterator it = traces.find (filename);
+  if (it != traces.end ())
+    {
+      return it->second;
+    }
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return 0;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || static_cast<uint64_t> (st.st_size) < HEADER_SIZE)
+    {
+      NS_LOG_WARN ("Unable to read the header of " << filename);
+      close (fd);
+      return 0;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << filename);
+      return 0;
+    }
+  Ptr<FadingTrace> trace = Ptr<FadingTrace> (new FadingTrace (), false);
+  trace->m_map = data;
+  trace->m_mapSize = st.st_size;
+
+  const uint8_t *p = static_cast<const uint8_t *> (data);
+  uint32_t magic;
+  uint16_t version;
+  double period;
+  std::memcpy (&magic, p, 4);
+  std::memcpy (&version, p + 4, 2);
+  std::memcpy (&trace->m_nRows, p + 8, 4);
+  std::memcpy (&trace->m_nSamples, p + 12, 4);
+  std::memcpy (&period, p + 16, 8);
+  if (magic != MAGIC || version != VERSION_MAJOR)
+    {
+      NS_LOG_WARN (filename << " is not a fading trace file");
+      return 0;
+    }
+  if (trace->m_nRows == 0 || trace->m_nSamples == 0 || !(period > 0)
+      || trace->m_mapSize != HEADER_SIZE + static_cast<uint64_t> (trace->m_nRows) * trace->m_nSamples * sizeof (double))
+    {
+      NS_LOG_WARN (filename << " is truncated or corrupted");
+      return 0;
+    }
+  trace->m_samplePeriod = Seconds (period);
+  trace->m_values = reinterpret_cast<const double *> (p + HEADER_SIZE);
+  traces[filename] = trace;
+  return trace;
+}
+
+Ptr<const FadingTrace>
+FadingTrace::LoadText (std::string filename, uint32_t nRows, uint32_t nSamples, Time samplePeriod)
+{
+  NS_LOG_FUNCTION (filename << nRows << nSamples << samplePeriod);
+  typedef std::map<std::string, Ptr<const FadingTrace> > TraceMap;
+  static SystemMutex mutex;
+  static TraceMap traces;
+
+  std::ostringstream key;
+  key << filename << ":" << nRows << "x" << nSamples << "@" << samplePeriod.GetTimeStep ();
+  CriticalSection cs (mutex);
+  TraceMap::const_iterator it = traces.find (key.str ());
+  if (it != traces.end ())
+    {
+      return it->second;
+    }
+
+  std::ifstream is (filename.c_str (), std::ifstream::in);
+  if (!is.good ())
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return 0;
+    }
+  Ptr<FadingTrace> trace = Create<FadingTrace> (nRows, nSamples, samplePeriod);
+  for (std::vector<double>::iterator v = trace->m_data.begin (); v != trace->m_data.end (); ++v)
+    {
+      is >> *v;
+    }
+  if (is.fail ())
+    {
+      NS_LOG_WARN (filename << " holds less than " << nRows << " rows of " << nSamples << " samples");
+      return 0;
+    }
+  traces[key.str ()] = trace;
+  return trace;
+}
+
+Ptr<const FadingTrace>
+FadingTrace::Get (std::string filename, uint32_t nRows, Time length, Time samplePeriod,
+                  double dopplerHz, uint32_t nOscillators,
+                  Ptr<UniformRandomVariable> uniform)
+{
+  NS_LOG_FUNCTION (filename << nRows << length << samplePeriod << dopplerHz << nOscillators << uniform);
+  if (!filename.empty ())
+    {
+      Ptr<const FadingTrace> trace = Load (filename);
+      NS_ABORT_MSG_IF (trace == 0, "Unable to load the fading trace " << filename);
+      return trace;
+    }
+  NS_ABORT_MSG_IF (!samplePeriod.IsStrictlyPositive (), "The sample period of the fading trace must be positive");
+  uint64_t nSamples = length.GetTimeStep () / samplePeriod.GetTimeStep ();
+  NS_ABORT_MSG_IF (nSamples == 0, "The fading trace is shorter than its sample period");
+  NS_ABORT_MSG_IF (nSamples > std::numeric_limits<uint32_t>::max (), "The fading trace is too long");
+  return Generate (nRows, static_cast<uint32_t> (nSamples), samplePeriod, dopplerHz, nOscillators, uniform);
+}
+
+bool
+FadingTrace::Save (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return false;
+    }
+  uint8_t header[HEADER_SIZE];
+  uint32_t magic = MAGIC;
+  uint16_t version = VERSION_MAJOR;
+  uint16_t padding = 0;
+  double period = m_samplePeriod.GetSeconds ();
+  std::memcpy (header, &magic, 4);
+  std::memcpy (header + 4, &version, 2);
+  std::memcpy (header + 6, &padding, 2);
+  std::memcpy (header + 8, &m_nRows, 4);
+  std::memcpy (header + 12, &m_nSamples, 4);
+  std::memcpy (header + 16, &period, 8);
+  os.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+  os.write (reinterpret_cast<const char *> (m_values), static_cast<uint64_t> (m_nRows) * m_nSamples * sizeof (double));
+  return os.good ();
+}
+
+uint32_t
+FadingTrace::GetNRows (void) const
+{
+  return m_nRows;
+}
+
+uint32_t
+FadingTrace::GetNSamples (void) const
+{
+  return m_nSamples;
+}
+
+Time
+FadingTrace::GetSamplePeriod (void) const
+{
+  return m_samplePeriod;
+}
+
+void
+FadingTrace::Set (uint32_t row, uint32_t sample, double gainDb)
+{
+  NS_ASSERT_MSG (m_map == 0, "A mapped fading trace is read-only");
+  NS_ASSERT (row < m_nRows && sample < m_nSamples);
+  m_data[static_cast<uint64_t> (row) * m_nSamples + sample] = gainDb;
+}
+
+} // namespace ns3
@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FADING_TRACE_H
+#define FADING_TRACE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class UniformRandomVariable;
+
+/**
+ * \ingroup propagation
+ * \brief a table of fading gains, shared by the links of fading models
+ *
+ * The trace holds a number of rows (e.g., one per resource block or
+ * sub-band) of fading gains in dB, sampled at a fixed period.  The rows
+ * are stored contiguously, in row-major order, so that reading a gain is
+ * an array lookup.  The fading models read the trace at a random offset
+ * for each link, so a single trace is shared by all the links.
+ *
+ * A trace is either generated with a sum of sinusoids (Jakes) model, or
+ * loaded from a binary file: the file is mapped in memory, and the traces
+ * loaded from the same file are shared by all the models of a simulation
+ * (and the pages of the file by all the processes which map it).
+ *
+ * The binary file is made of a 24 bytes header (the magic number, the
+ * version, two bytes of padding, the number of rows, the number of
+ * samples per row and the sample period in seconds, as a double) followed
+ * by the gains in dB, as doubles, all in the byte order of the host.
+ */
+class FadingTrace : public SimpleRefCount<FadingTrace>
+{
+public:
+  /**
+   * \param nRows the number of rows
+   * \param nSamples the number of samples of each row
+   * \param samplePeriod the sample period
+   *
+   * The gains are initialized to 0 dB.
+   */
+  FadingTrace (uint32_t nRows, uint32_t nSamples, Time samplePeriod);
+  ~FadingTrace ();
+
+  /**
+   * \brief Generate a Rayleigh fading trace
+   *
+   * The complex channel gain of each row is the sum of nOscillators
+   * sinusoids of the Doppler frequency, with random angles of arrival and
+   * phases, normalized to a mean power of 1.  The rows are independent.
+   *
+   * \param nRows the number of rows
+   * \param nSamples the number of samples of each row
+   * \param samplePeriod the sample period
+   * \param dopplerHz the maximum Doppler frequency, in Hz
+   * \param nOscillators the number of sinusoids of each row
+   * \param uniform a uniform random variable in [0, 1)
+   * \returns the trace
+   */
+  static Ptr<FadingTrace> Generate (uint32_t nRows, uint32_t nSamples, Time samplePeriod,
+                                    double dopplerHz, uint32_t nOscillators,
+                                    Ptr<UniformRandomVariable> uniform);
+
+  /**
+   * \brief Load a trace from a binary file
+   *
+   * The file is mapped only once: loading it again returns the same trace.
+   *
+   * \param filename the file name
+   * \returns the trace, or 0 if the file is not a valid trace file
+   */
+  static Ptr<const FadingTrace> Load (std::string filename);
+
+  /**
+   * \brief Load a trace from a text file
+   *
+   * The file holds the gains in dB separated by white spaces, row after
+   * row.  The file is parsed only once for given dimensions: loading it
+   * again returns the same trace.
+   *
+   * \param filename the file name
+   * \param nRows the number of rows
+   * \param nSamples the number of samples of each row
+   * \param samplePeriod the sample period
+   * \returns the trace, or 0 if the file holds less than nRows * nSamples gains
+   */
+  static Ptr<const FadingTrace> LoadText (std::string filename, uint32_t nRows, uint32_t nSamples, Time samplePeriod);
+
+  /**
+   * \brief Get the trace of a fading model
+   *
+   * Load the binary file if its name is not empty, and abort if it is not
+   * a valid trace file.  Otherwise, generate a trace of the given length.
+   *
+   * \param filename the binary file, or empty to generate the trace
+   * \param nRows the number of rows of a generated trace
+   * \param length the length of a generated trace
+   * \param samplePeriod the sample period of a generated trace
+   * \param dopplerHz the maximum Doppler frequency of a generated trace, in Hz
+   * \param nOscillators the number of sinusoids of each row of a generated trace
+   * \param uniform a uniform random variable in [0, 1)
+   * \returns the trace
+   */
+  static Ptr<const FadingTrace> Get (std::string filename, uint32_t nRows, Time length, Time samplePeriod,
+                                     double dopplerHz, uint32_t nOscillators,
+                                     Ptr<UniformRandomVariable> uniform);
+
+  /**
+   * \brief Save the trace in a binary file
+   * \param filename the file name
+   * \returns true on success
+   */
+  bool Save (std::string filename) const;
+
+  /**
+   * \returns the number of rows
+   */
+  uint32_t GetNRows (void) const;
+  /**
+   * \returns the number of samples of each row
+   */
+  uint32_t GetNSamples (void) const;
+  /**
+   * \returns the sample period
+   */
+  Time GetSamplePeriod (void) const;
+
+  /**
+   * \param row the row
+   * \param sample the sample
+   * \returns the gain, in dB
+   */
+  double Get (uint32_t row, uint32_t sample) const
+  {
+    return m_values[static_cast<uint64_t> (row) * m_nSamples + sample];
+  }
+  /**
+   * \param row the row
+   * \returns the gains of the row, in dB
+   */
+  const double * GetRow (uint32_t row) const
+  {
+    return m_values + static_cast<uint64_t> (row) * m_nSamples;
+  }
+  /**
+   * \param row the row
+   * \param sample the sample
+   * \param gainDb the gain, in dB
+   *
+   * The trace must not have been loaded from a file.
+   */
+  void Set (uint32_t row, uint32_t sample, double gainDb);
+
+  /// Magic number of the fading trace files ("ns3f")
+  static const uint32_t MAGIC = 0x6e733366;
+  /// Version of the format of the fading trace files
+  static const uint16_t VERSION_MAJOR = 1;
+  /// Size of the header of the fading trace files
+  static const uint32_t HEADER_SIZE = 24;
+
+private:
+  FadingTrace ();
+  /**
+   * \brief Copy constructor: not implemented
+   * \param o object to copy
+   */
+  FadingTrace (const FadingTrace &o);
+  /**
+   * \brief Assignment operator: not implemented
+   * \param o object to copy
+   * \returns a reference to this object
+   */
+  FadingTrace &operator = (const FadingTrace &o);
+
+  uint32_t m_nRows;                //!< number of rows
+  uint32_t m_nSamples;             //!< number of samples of each row
+  Time m_samplePeriod;             //!< sample period
+  const double *m_values;          //!< the gains in dB, row after row
+  std::vector<double> m_data;      //!< storage of the gains, unless they are mapped
+  void *m_map;                     //!< mapped file, if the trace was loaded
+  uint64_t m_mapSize;              //!< size of the mapped file
+};
+
+/**
+ * \ingroup propagation
+ * \brief the offset of a link in a fading trace
+ */
+struct FadingTraceOffset : public SimpleRefCount<FadingTraceOffset>
+{
+  uint32_t row;     //!< the first row read by the link
+  uint32_t sample;  //!< the sample read by the link at time zero
+};
+
+} // namespace ns3
+
+#endif /* FADING_TRACE_H */
@@ -0,0 +1,394 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/hash.h"
+#include "ns3/double.h"
+#include "ns3/node.h"
+#include "ns3/mobility-model.h"
+#include "ns3/mobility-grid.h"
+#include "precomputed-propagation-loss-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PrecomputedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (PrecomputedPropagationLossModel);
+
+/**
+ * Size of the header of the matrix files: magic, version, padding, number
+ * of nodes, fingerprint of the positions of the nodes and number of pairs
+ */
+static const uint32_t HEADER_SIZE = 4 + 2 + 2 + 4 + 4 + 8;
+
+TypeId
+PrecomputedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PrecomputedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<PrecomputedPropagationLossModel> ()
+    .AddAttribute ("MaxRange",
+                   "The maximum distance, in meters, of the pairs of nodes whose loss is computed.",
+                   DoubleValue (std::numeric_limits<double>::infinity ()),
+                   MakeDoubleAccessor (&PrecomputedPropagationLossModel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("DefaultLoss",
+                   "The loss, in dB, of the pairs of nodes whose loss is not stored.",
+                   DoubleValue (1000),
+                   MakeDoubleAccessor (&PrecomputedPropagationLossModel::m_defaultLoss),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+PrecomputedPropagationLossModel::PrecomputedPropagationLossModel ()
+  : m_maxRange (std::numeric_limits<double>::infinity ()),
+    m_defaultLoss (1000),
+    m_nNodes (0),
+    m_fingerprint (0),
+    m_nLinks (0),
+    m_rowStart (0),
+    m_columns (0),
+    m_losses (0),
+    m_map (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PrecomputedPropagationLossModel::~PrecomputedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+PrecomputedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+PrecomputedPropagationLossModel::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+  m_map = 0;
+  m_mapSize = 0;
+  m_index.clear ();
+  m_nNodes = 0;
+  m_fingerprint = 0;
+  m_nLinks = 0;
+  m_rowStart = 0;
+  m_columns = 0;
+  m_losses = 0;
+  m_rowStartData.clear ();
+  m_columnsData.clear ();
+  m_lossesData.clear ();
+}
+
+void
+PrecomputedPropagationLossModel::SetNodes (NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this);
+  m_nNodes = nodes.GetN ();
+  std::vector<double> coordinates;
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      Ptr<MobilityModel> mobility = nodes.Get (i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << nodes.Get (i)->GetId () << " has no mobility model");
+      m_index.push_back (std::make_pair (PeekPointer (mobility), i));
+      Vector position = mobility->GetPosition ();
+      coordinates.push_back (position.x);
+      coordinates.push_back (position.y);
+      coordinates.push_back (position.z);
+    }
+  std::sort (m_index.begin (), m_index.end ());
+  m_fingerprint = coordinates.empty () ? 0 : Hash32 (reinterpret_cast<const char *> (&coordinates[0]),
+                                                     coordinates.size () * sizeof (double));
+}
+
+uint32_t
+PrecomputedPropagationLossModel::GetIndex (const MobilityModel *mobility) const
+{
+  std::vector<std::pair<const MobilityModel *, uint32_t> >::const_iterator it;
+  it = std::lower_bound (m_index.begin (), m_index.end (), std::make_pair (mobility, static_cast<uint32_t> (0)));
+  if (it == m_index.end () || it->first != mobility)
+    {
+      return m_nNodes;
+    }
+  return it->second;
+}
+
+void
+PrecomputedPropagationLossModel::Compute (NodeContainer nodes, Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  Clear ();
+  SetNodes (nodes);
+
+  std::vector<Ptr<MobilityModel> > mobilities;
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      mobilities.push_back (nodes.Get (i)->GetObject<MobilityModel> ());
+    }
+  // only the pairs of nearby cells are considered when the range is bounded
+  Ptr<MobilityGrid> grid;
+  if (m_maxRange < std::numeric_limits<double>::infinity () && m_maxRange > 0)
+    {
+      grid = Create<MobilityGrid> (m_maxRange, Seconds (1));
+      for (uint32_t i = 0; i < m_nNodes; ++i)
+        {
+          grid->Add (mobilities[i], i);
+        }
+    }
+
+  std::vector<uint32_t> candidates;
+  m_rowStartData.push_back (0);
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      candidates.clear ();
+      Vector position = mobilities[i]->GetPosition ();
+      if (grid != 0)
+        {
+          grid->GetCandidates (position, m_maxRange, candidates);
+          std::sort (candidates.begin (), candidates.end ());
+        }
+      else
+        {
+          for (uint32_t j = 0; j < m_nNodes; ++j)
+            {
+              candidates.push_back (j);
+            }
+        }
+      for (std::vector<uint32_t>::const_iterator j = candidates.begin (); j != candidates.end (); ++j)
+        {
+          if (*j == i || CalculateDistance (position, mobilities[*j]->GetPosition ()) > m_maxRange)
+            {
+              continue;
+            }
+          m_columnsData.push_back (*j);
+          m_lossesData.push_back (-model->CalcRxPower (0, mobilities[i], mobilities[*j]));
+        }
+      m_rowStartData.push_back (m_columnsData.size ());
+    }
+  NS_ABORT_MSG_IF (m_columnsData.size () > std::numeric_limits<uint32_t>::max (), "Too many pairs of nodes in range");
+  if (grid != 0)
+    {
+      grid->Clear ();
+    }
+
+  m_nLinks = m_columnsData.size ();
+  m_rowStart = &m_rowStartData[0];
+  m_columns = m_columnsData.empty () ? 0 : &m_columnsData[0];
+  m_losses = m_lossesData.empty () ? 0 : &m_lossesData[0];
+  NS_LOG_DEBUG ("computed the loss of " << m_nLinks << " pairs of " << m_nNodes << " nodes");
+}
+
+bool
+PrecomputedPropagationLossModel::Save (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (m_rowStart != 0, "No matrix to save");
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return false;
+    }
+  uint8_t header[HEADER_SIZE];
+  uint32_t magic = MAGIC;
+  uint16_t version = VERSION_MAJOR;
+  uint16_t padding = 0;
+  std::memcpy (header, &magic, 4);
+  std::memcpy (header + 4, &version, 2);
+  std::memcpy (header + 6, &padding, 2);
+  std::memcpy (header + 8, &m_nNodes, 4);
+  std::memcpy (header + 12, &m_fingerprint, 4);
+  std::memcpy (header + 16, &m_nLinks, 8);
+  os.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+  // the losses come first to keep them aligned in the mapped file
+  os.write (reinterpret_cast<const char *> (m_losses), m_nLinks * sizeof (double));
+  os.write (reinterpret_cast<const char *> (m_rowStart), (m_nNodes + 1) * sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (m_columns), m_nLinks * sizeof (uint32_t));
+  return os.good ();
+}
+
+bool
+PrecomputedPropagationLossModel::Load (std::string filename, NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Clear ();
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Unable to open " << filename);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || static_cast<uint64_t> (st.st_size) < HEADER_SIZE)
+    {
+      NS_LOG_WARN ("Unable to read the header of " << filename);
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << filename);
+      return false;
+    }
+  m_map = data;
+  m_mapSize = st.st_size;
+
+  const uint8_t *p = static_cast<const uint8_t *> (data);
+  uint32_t magic;
+  uint16_t version;
+  uint32_t nNodes;
+  uint32_t fingerprint;
+  uint64_t nLinks;
+  std::memcpy (&magic, p, 4);
+  std::memcpy (&version, p + 4, 2);
+  std::memcpy (&nNodes, p + 8, 4);
+  std::memcpy (&fingerprint, p + 12, 4);
+  std::memcpy (&nLinks, p + 16, 8);
+  if (magic != MAGIC || version != VERSION_MAJOR)
+    {
+      NS_LOG_WARN (filename << " is not a path loss matrix file");
+      Clear ();
+      return false;
+    }
+  if (nNodes != nodes.GetN ()
+      || nLinks > std::numeric_limits<uint32_t>::max ()
+      || m_mapSize != HEADER_SIZE + nLinks * (sizeof (double) + sizeof (uint32_t)) + (nNodes + 1) * static_cast<uint64_t> (sizeof (uint32_t)))
+    {
+      NS_LOG_WARN (filename << " does not match the " << nodes.GetN () << " nodes");
+      Clear ();
+      return false;
+    }
+  SetNodes (nodes);
+  if (fingerprint != m_fingerprint)
+    {
+      NS_LOG_WARN (filename << " was computed for other positions of the nodes");
+      Clear ();
+      return false;
+    }
+  const double *losses = reinterpret_cast<const double *> (p + HEADER_SIZE);
+  const uint32_t *rowStart = reinterpret_cast<const uint32_t *> (losses + nLinks);
+  const uint32_t *columns = rowStart + nNodes + 1;
+  if (!IsValid (nNodes, nLinks, rowStart, columns))
+    {
+      NS_LOG_WARN (filename << " is corrupted");
+      Clear ();
+      return false;
+    }
+  m_nLinks = nLinks;
+  m_losses = losses;
+  m_rowStart = rowStart;
+  m_columns = columns;
+  return true;
+}
+
+bool
+PrecomputedPropagationLossModel::IsValid (uint32_t nNodes, uint64_t nLinks,
+                                          const uint32_t *rowStart, const uint32_t *columns)
+{
+  NS_LOG_FUNCTION (nNodes << nLinks);
+  if (rowStart[0] != 0 || rowStart[nNodes] != nLinks)
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      if (rowStart[i + 1] < rowStart[i])
+        {
+          return false;
+        }
+      for (uint32_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+        {
+          if (columns[k] >= nNodes || (k > rowStart[i] && columns[k] <= columns[k - 1]))
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+uint32_t
+PrecomputedPropagationLossModel::GetNNodes (void) const
+{
+  return m_nNodes;
+}
+
+uint64_t
+PrecomputedPropagationLossModel::GetNLinks (void) const
+{
+  return m_nLinks;
+}
+
+double
+PrecomputedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                Ptr<MobilityModel> a,
+                                                Ptr<MobilityModel> b) const
+{
+  uint32_t i = GetIndex (PeekPointer (a));
+  uint32_t j = GetIndex (PeekPointer (b));
+  if (i == m_nNodes || j == m_nNodes)
+    {
+      return txPowerDbm - m_defaultLoss;
+    }
+  const uint32_t *first = m_columns + m_rowStart[i];
+  const uint32_t *last = m_columns + m_rowStart[i + 1];
+  const uint32_t *it = std::lower_bound (first, last, j);
+  if (it == last || *it != j)
+    {
+      return txPowerDbm - m_defaultLoss;
+    }
+  return txPowerDbm - m_losses[it - m_columns];
+}
+
+int64_t
+PrecomputedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+bool
+PrecomputedPropagationLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PRECOMPUTED_PROPAGATION_LOSS_MODEL_H
+#define PRECOMPUTED_PROPAGATION_LOSS_MODEL_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/node-container.h"
+#include "propagation-loss-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief The propagation loss of a static topology, computed once for all the pairs of nodes
+ *
+ * Compute evaluates a chain of loss models once for each ordered pair of
+ * nodes of a container whose distance is not larger than the MaxRange
+ * attribute, and stores the losses in a sparse matrix (for each
+ * transmitter, the receivers within range sorted by index, along with their
+ * loss).  CalcRxPower then looks the loss up in the matrix, so that the
+ * chain is not evaluated during the simulation.  The pairs beyond MaxRange,
+ * and those involving a mobility model which was not part of the
+ * container, get the DefaultLoss.
+ *
+ * The nodes must not move, and the chain must be deterministic and
+ * independent of the tx power, since it is evaluated at 0 dBm.  Fading
+ * models can be chained after this model with SetNext.
+ *
+ * The matrix can be saved to a binary file and loaded again in later runs
+ * with the same nodes: the file is mapped in memory, so loading is
+ * immediate and the pages are shared by the processes which map the same
+ * file.  The nodes are identified by their index in the container, and the
+ * file is in the byte order of the host.  The file holds a fingerprint of
+ * the positions of the nodes, and Load rejects a matrix computed for other
+ * positions, as well as a matrix whose indices are out of bounds.
+ */
+class PrecomputedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PrecomputedPropagationLossModel ();
+  virtual ~PrecomputedPropagationLossModel ();
+
+  /**
+   * \brief Compute the loss between the nodes
+   *
+   * \param nodes the nodes, which must have a mobility model
+   * \param model the first loss model of the chain to evaluate
+   */
+  void Compute (NodeContainer nodes, Ptr<PropagationLossModel> model);
+
+  /**
+   * \brief Save the matrix in a binary file
+   * \param filename file name
+   * \returns true on success
+   */
+  bool Save (std::string filename) const;
+
+  /**
+   * \brief Map a matrix saved in a binary file
+   *
+   * \param filename file name
+   * \param nodes the nodes the matrix was computed for, in the same order
+   *        and at the same positions
+   * \returns true on success
+   */
+  bool Load (std::string filename, NodeContainer nodes);
+
+  /**
+   * \returns the number of nodes of the matrix
+   */
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * \returns the number of pairs of nodes whose loss is stored
+   */
+  uint64_t GetNLinks (void) const;
+
+  /// Magic number of the matrix files ("ns3m")
+  static const uint32_t MAGIC = 0x6e73336d;
+  /// Version of the format of the matrix files
+  static const uint16_t VERSION_MAJOR = 2;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  PrecomputedPropagationLossModel (const PrecomputedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  PrecomputedPropagationLossModel &operator = (const PrecomputedPropagationLossModel &);
+
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
+
+  /**
+   * \brief Index the mobility models of the nodes
+   * \param nodes the nodes
+   */
+  void SetNodes (NodeContainer nodes);
+  /**
+   * \param mobility a mobility model
+   * \returns the index of the node of the mobility model, or m_nNodes
+   */
+  uint32_t GetIndex (const MobilityModel *mobility) const;
+  /**
+   * \brief Release the matrix
+   */
+  void Clear (void);
+  /**
+   * \brief Check the structure of a sparse matrix
+   *
+   * \param nNodes the number of nodes
+   * \param nLinks the number of stored pairs
+   * \param rowStart the first stored pair of each transmitter, and nLinks
+   * \param columns the receiver of each stored pair
+   * \returns true if the rows are consistent and their receivers are valid
+   *          and sorted
+   */
+  static bool IsValid (uint32_t nNodes, uint64_t nLinks,
+                       const uint32_t *rowStart, const uint32_t *columns);
+
+  double m_maxRange;                //!< maximum distance of the stored pairs, in meters
+  double m_defaultLoss;             //!< loss of the pairs which are not stored, in dB
+
+  /// Index of the node of each mobility model, sorted by mobility model
+  std::vector<std::pair<const MobilityModel *, uint32_t> > m_index;
+  uint32_t m_nNodes;                //!< number of nodes
+  uint32_t m_fingerprint;           //!< hash of the positions of the nodes
+  uint64_t m_nLinks;                //!< number of stored pairs
+  const uint32_t *m_rowStart;       //!< first stored pair of each transmitter, and m_nLinks
+  const uint32_t *m_columns;        //!< receiver of each stored pair
+  const double *m_losses;           //!< loss of each stored pair, in dB
+
+  std::vector<uint32_t> m_rowStartData;  //!< storage of the computed matrix
+  std::vector<uint32_t> m_columnsData;   //!< storage of the computed matrix
+  std::vector<double> m_lossesData;      //!< storage of the computed matrix
+  void *m_map;                      //!< mapped file, if the matrix was loaded
+  uint64_t m_mapSize;               //!< size of the mapped file
+};
+
+} // namespace ns3
+
+#endif /* PRECOMPUTED_PROPAGATION_LOSS_MODEL_H */
@@ -22,22 +22,75 @@
 
 #include "ns3/mobility-model.h"
 #include <map>
+#include <list>
+#include <algorithm>
 
 namespace ns3
 {
 /**
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
- * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
- * a couple of MobilityModels and a spectrum model UID
+ * Propagation path is identified by a couple of MobilityModels and a spectrum model UID.
+ * By default, propagation path a-->b and b-->a is the same thing.
+ *
+ * The cache may be bounded: when it is full, adding a path evicts the
+ * path which was least recently added or looked up.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  /**
+   * \param symmetric whether paths a-->b and b-->a are the same thing
+   * \param maxSize the maximum number of paths in the cache, or 0 if
+   *        the cache is not bounded
+   */
+  PropagationCache (bool symmetric = true, uint32_t maxSize = 0)
+    : m_symmetric (symmetric), m_maxSize (maxSize)
+  {};
   ~PropagationCache () {};
 
+  /**
+   * \param symmetric whether paths a-->b and b-->a are the same thing
+   *
+   * The cache is cleared.
+   */
+  void SetSymmetric (bool symmetric)
+  {
+    Clear ();
+    m_symmetric = symmetric;
+  };
+
+  /**
+   * \param maxSize the maximum number of paths in the cache, or 0 if
+   *        the cache is not bounded
+   *
+   * The least recently used paths are evicted if the cache holds more
+   * than maxSize paths.
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+    Shrink ();
+  };
+
+  /**
+   * \return the number of paths in the cache
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_pathCache.size ();
+  };
+
+  /**
+   * Remove all the paths from the cache
+   */
+  void Clear (void)
+  {
+    m_pathCache.clear ();
+    m_lru.clear ();
+  };
+
   /**
    * Get the model associated with the path
    * \param a 1st node mobility model
@@ -47,13 +100,14 @@ public:
    */
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid, m_symmetric);
     typename PathCache::iterator it = m_pathCache.find (key);
     if (it == m_pathCache.end ())
       {
         return 0;
       }
-    return it->second;
+    m_lru.splice (m_lru.begin (), m_lru, it->second.second);
+    return it->second.first;
   };
 
   /**
@@ -65,9 +119,11 @@ public:
    */
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid, m_symmetric);
     NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    typename std::list<PropagationPathIdentifier>::iterator lru = m_lru.insert (m_lru.begin (), key);
+    m_pathCache.insert (std::make_pair (key, std::make_pair (data, lru)));
+    Shrink ();
   };
 private:
   /// Each path is identified by
@@ -78,10 +134,16 @@ private:
      * @param a 1st node mobility model
      * @param b 2nd node mobility model
      * @param modelUid model UID
+     * @param symmetric whether the order of the mobility models does not matter
      */
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
+    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid, bool symmetric) :
       m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
+    {
+      if (symmetric && m_dstMobility < m_srcMobility)
+        {
+          std::swap (m_srcMobility, m_dstMobility);
+        }
+    };
     Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
     Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
     uint32_t m_spectrumModelUid; //!< model UID
@@ -93,7 +155,8 @@ private:
      * to be used in containers requiring a order (of any kind).
      *
      * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
+     * Otherwise, the comparison is based on the pointers of the Mobility models,
+     * which the constructor has already sorted if the links are symmetrical.
      *
      * \param other Right value of the operator.
      * \returns True if the Left value is less than the Right value.
@@ -104,23 +167,37 @@ private:
         {
           return m_spectrumModelUid < other.m_spectrumModelUid;
         }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
+      if (m_srcMobility != other.m_srcMobility)
         {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
+          return m_srcMobility < other.m_srcMobility;
         }
-      return false;
+      return m_dstMobility < other.m_dstMobility;
     }
   };
 
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
+  /**
+   * Evict the least recently used paths until the size bound is met
+   */
+  void Shrink (void)
+  {
+    if (m_maxSize == 0)
+      {
+        return;
+      }
+    while (m_pathCache.size () > m_maxSize)
+      {
+        m_pathCache.erase (m_lru.back ());
+        m_lru.pop_back ();
+      }
+  };
+
+  /// Typedef: PropagationPathIdentifier, Ptr<T> and position in the LRU list
+  typedef std::map<PropagationPathIdentifier, std::pair<Ptr<T>, typename std::list<PropagationPathIdentifier>::iterator> > PathCache;
 private:
   PathCache m_pathCache; //!< Path cache
+  std::list<PropagationPathIdentifier> m_lru; //!< Paths from the most to the least recently used
+  bool m_symmetric; //!< Whether path a-->b and b-->a is the same thing
+  uint32_t m_maxSize; //!< Maximum number of paths, or 0
 };
 } // namespace ns3
 
@@ -24,11 +24,14 @@
 #include "propagation-loss-model.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -82,6 +85,37 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+void
+PropagationLossModel::CalcRxPowerBatch (double txPowerDbm,
+                                        Ptr<MobilityModel> a,
+                                        const std::vector<Ptr<MobilityModel> > &b,
+                                        std::vector<double> &rxPowerDbm) const
+{
+  rxPowerDbm.assign (b.size (), txPowerDbm);
+  std::vector<double> distances (b.size ());
+  Vector position = a->GetPosition ();
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      distances[i] = CalculateDistance (position, b[i]->GetPosition ());
+    }
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowerBatch (a, b, distances, rxPowerDbm);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                          const std::vector<Ptr<MobilityModel> > &b,
+                                          const std::vector<double> &distances,
+                                          std::vector<double> &powerDbm) const
+{
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      powerDbm[i] = DoCalcRxPower (powerDbm[i], a, b[i]);
+    }
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -94,6 +128,49 @@ PropagationLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+double
+PropagationLossModel::CalcMaxDistance (double txPowerDbm, double thresholdDbm) const
+{
+  NS_LOG_FUNCTION (this << txPowerDbm << thresholdDbm);
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  const double maxDistance = 1e7;
+  double low = 0;
+  double high = 1;
+  b->SetPosition (Vector (high, 0, 0));
+  while (CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+    {
+      low = high;
+      high *= 2;
+      if (high >= maxDistance)
+        {
+          return maxDistance;
+        }
+      b->SetPosition (Vector (high, 0, 0));
+    }
+  // the receive power is above the threshold at low and below it at high
+  while (high - low > 0.01)
+    {
+      double middle = (low + high) / 2;
+      b->SetPosition (Vector (middle, 0, 0));
+      if (CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return high;
+}
+
+bool
+PropagationLossModel::IsThreadSafe (void) const
+{
+  return false;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
@@ -271,12 +348,44 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+void
+FriisPropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                               const std::vector<Ptr<MobilityModel> > &b,
+                                               const std::vector<double> &distances,
+                                               std::vector<double> &powerDbm) const
+{
+  // same computation as DoCalcRxPower, for each distance
+  double numerator = m_lambda * m_lambda;
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      if (distance < 3*m_lambda)
+        {
+          NS_LOG_WARN ("distance not within the far field region => inaccurate propagation loss value");
+        }
+      if (distance <= 0)
+        {
+          powerDbm[i] -= m_minLoss;
+          continue;
+        }
+      double denominator = 16 * M_PI * M_PI * distance * distance * m_systemLoss;
+      double lossDb = -10 * log10 (numerator / denominator);
+      powerDbm[i] -= std::max (lossDb, m_minLoss);
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+FriisPropagationLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -534,12 +643,36 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+void
+LogDistancePropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                     const std::vector<Ptr<MobilityModel> > &b,
+                                                     const std::vector<double> &distances,
+                                                     std::vector<double> &powerDbm) const
+{
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      if (distances[i] <= m_referenceDistance)
+        {
+          powerDbm[i] -= m_referenceLoss;
+          continue;
+        }
+      double pathLossDb = 10 * m_exponent * std::log10 (distances[i] / m_referenceDistance);
+      powerDbm[i] += -m_referenceLoss - pathLossDb;
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+LogDistancePropagationLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeLogDistancePropagationLossModel);
@@ -636,12 +769,58 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - pathLossDb;
 }
 
+void
+ThreeLogDistancePropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                                          const std::vector<Ptr<MobilityModel> > &b,
+                                                          const std::vector<double> &distances,
+                                                          std::vector<double> &powerDbm) const
+{
+  // the losses at the start of the second and third fields, summed in
+  // the same order as in DoCalcRxPower
+  double loss1 = m_referenceLoss
+    + 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0);
+  double loss2 = loss1
+    + 10 * m_exponent1 * std::log10 (m_distance2 / m_distance1);
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      double distance = distances[i];
+      NS_ASSERT (distance >= 0);
+      double pathLossDb;
+      if (distance < m_distance0)
+        {
+          pathLossDb = 0;
+        }
+      else if (distance < m_distance1)
+        {
+          pathLossDb = m_referenceLoss
+            + 10 * m_exponent0 * std::log10 (distance / m_distance0);
+        }
+      else if (distance < m_distance2)
+        {
+          pathLossDb = loss1
+            + 10 * m_exponent1 * std::log10 (distance / m_distance1);
+        }
+      else
+        {
+          pathLossDb = loss2
+            + 10 * m_exponent2 * std::log10 (distance / m_distance2);
+        }
+      powerDbm[i] -= pathLossDb;
+    }
+}
+
 int64_t
 ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+ThreeLogDistancePropagationLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (NakagamiPropagationLossModel);
@@ -798,12 +977,27 @@ FixedRssLossModel::DoCalcRxPower (double txPowerDbm,
   return m_rss;
 }
 
+void
+FixedRssLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                       const std::vector<Ptr<MobilityModel> > &b,
+                                       const std::vector<double> &distances,
+                                       std::vector<double> &powerDbm) const
+{
+  std::fill (powerDbm.begin (), powerDbm.end (), m_rss);
+}
+
 int64_t
 FixedRssLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+FixedRssLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (MatrixPropagationLossModel);
@@ -924,12 +1118,201 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+void
+RangePropagationLossModel::DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                               const std::vector<Ptr<MobilityModel> > &b,
+                                               const std::vector<double> &distances,
+                                               std::vector<double> &powerDbm) const
+{
+  for (uint32_t i = 0; i < distances.size (); i++)
+    {
+      if (distances[i] > m_range)
+        {
+          powerDbm[i] = -1000;
+        }
+    }
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
   return 0;
 }
 
+bool
+RangePropagationLossModel::IsThreadSafe (void) const
+{
+  return true;
+}
+
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("Model",
+                   "The first loss model of the chain whose receive power is cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetModel,
+                                        &CachedPropagationLossModel::GetModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("PositionQuantum",
+                   "The distance, in meters, that the mobility models of a link may "
+                   "move before its receive power is computed again.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&CachedPropagationLossModel::m_positionQuantum),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Symmetric",
+                   "Whether the links a-->b and b-->a have the same receive power.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CachedPropagationLossModel::SetSymmetric,
+                                        &CachedPropagationLossModel::GetSymmetric),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxSize",
+                   "The maximum number of cached links, or 0 if it is not bounded.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::SetMaxSize,
+                                         &CachedPropagationLossModel::GetMaxSize),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+  : m_positionQuantum (0),
+    m_symmetric (false),
+    m_maxSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_cache.Clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_cache.Clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel (void) const
+{
+  return m_model;
+}
+
+void
+CachedPropagationLossModel::SetSymmetric (bool symmetric)
+{
+  NS_LOG_FUNCTION (this << symmetric);
+  m_symmetric = symmetric;
+  m_cache.SetSymmetric (symmetric);
+}
+
+bool
+CachedPropagationLossModel::GetSymmetric (void) const
+{
+  return m_symmetric;
+}
+
+void
+CachedPropagationLossModel::SetMaxSize (uint32_t maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+  m_maxSize = maxSize;
+  m_cache.SetMaxSize (maxSize);
+}
+
+uint32_t
+CachedPropagationLossModel::GetMaxSize (void) const
+{
+  return m_maxSize;
+}
+
+uint32_t
+CachedPropagationLossModel::GetCacheSize (void) const
+{
+  return m_cache.GetSize ();
+}
+
+void
+CachedPropagationLossModel::ClearCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_cache.Clear ();
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No loss model to cache");
+  Vector aPosition = a->GetPosition ();
+  Vector bPosition = b->GetPosition ();
+  Ptr<Entry> entry = m_cache.GetPathData (a, b, 0);
+  if (entry != 0 && entry->txPowerDbm == txPowerDbm)
+    {
+      // the entry of a symmetric link may have been computed for b-->a
+      const Vector &aCached = (entry->a == PeekPointer (a)) ? entry->aPosition : entry->bPosition;
+      const Vector &bCached = (entry->a == PeekPointer (a)) ? entry->bPosition : entry->aPosition;
+      if (m_positionQuantum == 0)
+        {
+          if (aPosition.x == aCached.x && aPosition.y == aCached.y && aPosition.z == aCached.z
+              && bPosition.x == bCached.x && bPosition.y == bCached.y && bPosition.z == bCached.z)
+            {
+              return entry->rxPowerDbm;
+            }
+        }
+      else if (CalculateDistance (aPosition, aCached) <= m_positionQuantum
+               && CalculateDistance (bPosition, bCached) <= m_positionQuantum)
+        {
+          return entry->rxPowerDbm;
+        }
+    }
+  if (entry == 0)
+    {
+      entry = Create<Entry> ();
+      m_cache.AddPathData (entry, a, b, 0);
+    }
+  entry->a = PeekPointer (a);
+  entry->aPosition = aPosition;
+  entry->bPosition = bPosition;
+  entry->txPowerDbm = txPowerDbm;
+  entry->rxPowerDbm = m_model->CalcRxPower (txPowerDbm, a, b);
+  NS_LOG_DEBUG ("rx power of link " << a << "-->" << b << " computed again: " << entry->rxPowerDbm);
+  return entry->rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_model == 0)
+    {
+      return 0;
+    }
+  return m_model->AssignStreams (stream);
+}
+
 // ------------------------------------------------------------------------- //
 
 } // namespace ns3
@@ -27,7 +27,11 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
+#include "ns3/simple-ref-count.h"
+#include "propagation-cache.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -93,6 +97,25 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * \brief Compute the Rx Power of several receivers
+   *
+   * Equivalent to calling CalcRxPower for each receiver, but each model of
+   * the chain processes all the receivers at once, and the distances to
+   * the receivers are computed only once.  The models draw their random
+   * variables for the receivers in the order of b, so the results are the
+   * same as those of CalcRxPower called for each receiver in turn.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param rxPowerDbm the reception power of each destination (in dBm), resized to the size of b
+   */
+  void CalcRxPowerBatch (double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         const std::vector<Ptr<MobilityModel> > &b,
+                         std::vector<double> &rxPowerDbm) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -106,6 +129,34 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Compute the distance at which the receive power falls below a threshold
+   *
+   * The chain of loss models is evaluated between two fixed positions
+   * and the distance is found by bisection, so the loss must be
+   * deterministic and increasing with the distance (e.g., Friis or
+   * log-distance models).  This is meant to bound the range of the
+   * receivers to consider for a transmission.
+   *
+   * \param txPowerDbm the tx power, in dBm
+   * \param thresholdDbm the receive power threshold, in dBm
+   * \returns the distance in meters, at most 1e7
+   */
+  double CalcMaxDistance (double txPowerDbm, double thresholdDbm) const;
+
+  /**
+   * \brief Whether this model can compute losses from several threads at once
+   *
+   * Models which draw random variables or update any state when computing
+   * a loss must not be called concurrently, so the default is false.
+   * Models whose loss is a pure function of their attributes and of the
+   * positions return true.  This only covers this model, not the models
+   * chained after it.
+   *
+   * \returns true if the loss can be computed concurrently
+   */
+  virtual bool IsThreadSafe (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -134,6 +185,22 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Updates the Rx Power of several receivers, taking into account only
+   * the particular PropagationLossModel.  The default implementation
+   * calls DoCalcRxPower for each receiver; models whose loss is a function
+   * of the distance override it with a loop over the distances.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility models of the destinations
+   * \param distances the distance from the source to each destination
+   * \param powerDbm the power of each destination (in dBm), before and after this model
+   */
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
@@ -321,7 +388,12 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
 
   /**
    * Transforms a Dbm value to Watt
@@ -529,7 +601,12 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
 
   /**
    *  Creates a default reference loss model
@@ -612,7 +689,12 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
 
   double m_distance0; //!< Beginning of the first (near) distance field
   double m_distance1; //!< Beginning of the second (middle) distance field.
@@ -745,8 +827,13 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
 
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
   double m_rss; //!< the received signal strength
 };
 
@@ -851,11 +938,126 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual void DoCalcRxPowerBatch (Ptr<MobilityModel> a,
+                                   const std::vector<Ptr<MobilityModel> > &b,
+                                   const std::vector<double> &distances,
+                                   std::vector<double> &powerDbm) const;
   virtual int64_t DoAssignStreams (int64_t stream);
+  virtual bool IsThreadSafe (void) const;
 private:
   double m_range; //!< Maximum Transmission Range (meters)
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Caches the receive power computed by a chain of loss models
+ *
+ * The receive power computed by the chain of loss models given by the
+ * Model attribute is stored for each pair of mobility models, and reused
+ * as long as the tx power is the same and the two mobility models have
+ * not moved by more than PositionQuantum meters since it was computed.
+ * With the default quantum of zero, the cached value is reused only if
+ * the positions are unchanged, so the results are the same as those of
+ * the cached chain, while the loss of a static topology is computed once
+ * per link.
+ *
+ * The cached chain must be deterministic (e.g., log-distance, COST-231,
+ * Okumura-Hata, ITU-R P.1411 or building models): the fading models
+ * must be chained after this model instead, with SetNext.  If the Symmetric
+ * attribute is true, the links a-->b and b-->a share their cache entry,
+ * which is only correct if the cached chain does not depend on the
+ * direction of the link (unlike, e.g., Okumura-Hata).  The MaxSize
+ * attribute bounds the number of cached links, the least recently used
+ * ones being evicted first.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the first loss model of the chain to cache
+   */
+  void SetModel (Ptr<PropagationLossModel> model);
+  /**
+   * \returns the first loss model of the cached chain
+   */
+  Ptr<PropagationLossModel> GetModel (void) const;
+
+  /**
+   * \returns the number of links in the cache
+   */
+  uint32_t GetCacheSize (void) const;
+
+  /**
+   * \brief Remove all the links from the cache
+   *
+   * This must be called if the cached chain is reconfigured.
+   */
+  void ClearCache (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel &operator = (const CachedPropagationLossModel &);
+
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * \param symmetric whether the links a-->b and b-->a share their entry
+   */
+  void SetSymmetric (bool symmetric);
+  /**
+   * \returns whether the links a-->b and b-->a share their entry
+   */
+  bool GetSymmetric (void) const;
+  /**
+   * \param maxSize the maximum number of cached links, or 0
+   */
+  void SetMaxSize (uint32_t maxSize);
+  /**
+   * \returns the maximum number of cached links, or 0
+   */
+  uint32_t GetMaxSize (void) const;
+
+  /// Receive power of a link, and the state it was computed for
+  struct Entry : public SimpleRefCount<Entry>
+  {
+    const MobilityModel *a;  //!< the source of the link
+    Vector aPosition;        //!< position of the source
+    Vector bPosition;        //!< position of the destination
+    double txPowerDbm;       //!< tx power, in dBm
+    double rxPowerDbm;       //!< receive power, in dBm
+  };
+
+  Ptr<PropagationLossModel> m_model;  //!< the cached chain
+  double m_positionQuantum;           //!< maximum movement of a cached link, in meters
+  bool m_symmetric;                   //!< whether a-->b and b-->a share their entry
+  uint32_t m_maxSize;                 //!< maximum number of cached links, or 0
+  mutable PropagationCache<Entry> m_cache; //!< cached links
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/mobility-model.h"
+#include "trace-fading-propagation-loss-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceFadingPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceFadingPropagationLossModel);
+
+TypeId
+TraceFadingPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceFadingPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<TraceFadingPropagationLossModel> ()
+    .AddAttribute ("TraceFilename",
+                   "The binary file of the fading trace, or empty to generate the trace.",
+                   StringValue (""),
+                   MakeStringAccessor (&TraceFadingPropagationLossModel::m_traceFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("TraceLength",
+                   "The length of a generated trace.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TraceFadingPropagationLossModel::m_traceLength),
+                   MakeTimeChecker ())
+    .AddAttribute ("SamplePeriod",
+                   "The sample period of a generated trace.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TraceFadingPropagationLossModel::m_samplePeriod),
+                   MakeTimeChecker ())
+    .AddAttribute ("DopplerFrequencyHz",
+                   "The maximum Doppler frequency of a generated trace, in Hz.",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&TraceFadingPropagationLossModel::m_dopplerHz),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("NumberOfOscillators",
+                   "The number of sinusoids of a generated trace.",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&TraceFadingPropagationLossModel::m_nOscillators),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+TraceFadingPropagationLossModel::TraceFadingPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_uniform = CreateObject<UniformRandomVariable> ();
+}
+
+TraceFadingPropagationLossModel::~TraceFadingPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceFadingPropagationLossModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_uniform = 0;
+  m_trace = 0;
+  m_offsets.Clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+Ptr<const FadingTrace>
+TraceFadingPropagationLossModel::GetTrace (void) const
+{
+  if (m_trace == 0)
+    {
+      m_trace = FadingTrace::Get (m_traceFilename, 1, m_traceLength, m_samplePeriod, m_dopplerHz, m_nOscillators, m_uniform);
+    }
+  return m_trace;
+}
+
+double
+TraceFadingPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                                Ptr<MobilityModel> a,
+                                                Ptr<MobilityModel> b) const
+{
+  Ptr<const FadingTrace> trace = GetTrace ();
+  Ptr<FadingTraceOffset> offset = m_offsets.GetPathData (a, b, 0);
+  if (offset == 0)
+    {
+      offset = Create<FadingTraceOffset> ();
+      offset->row = 0;
+      offset->sample = m_uniform->GetInteger (0, trace->GetNSamples () - 1);
+      m_offsets.AddPathData (offset, a, b, 0);
+    }
+  uint64_t sample = Simulator::Now ().GetTimeStep () / trace->GetSamplePeriod ().GetTimeStep ();
+  double gainDb = trace->Get (0, (offset->sample + sample) % trace->GetNSamples ());
+  NS_LOG_DEBUG ("fading of link " << a << "-->" << b << ": " << gainDb << " dB");
+  return txPowerDbm + gainDb;
+}
+
+int64_t
+TraceFadingPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  m_uniform->SetStream (stream);
+  return 1;
+}
+
+} // namespace ns3
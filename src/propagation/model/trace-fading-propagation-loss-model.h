@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_FADING_PROPAGATION_LOSS_MODEL_H
+#define TRACE_FADING_PROPAGATION_LOSS_MODEL_H
+
+#include <string>
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "propagation-loss-model.h"
+#include "propagation-cache.h"
+#include "fading-trace.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Fast fading read from a trace shared by all the links
+ *
+ * Unlike JakesPropagationLossModel, which evaluates a sum of sinusoids for
+ * each link and each packet, this model reads the fading gain of a link
+ * from a FadingTrace, at a random offset drawn when the link is first
+ * used: a gain costs one array lookup.  The trace is either loaded from
+ * the binary file given by the TraceFilename attribute, in which case it
+ * is shared by all the models using the same file, or generated with a
+ * Jakes model the first time the model is used.  The traces of the links
+ * overlap, but are independent as long as their offsets are further apart
+ * than the coherence time of the fading, so the trace should be much
+ * longer than it.  The links a-->b and b-->a share their fading.
+ *
+ * Only the first row of the trace is used.
+ */
+class TraceFadingPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TraceFadingPropagationLossModel ();
+  virtual ~TraceFadingPropagationLossModel ();
+
+  /**
+   * \returns the fading trace, loaded or generated if necessary
+   */
+  Ptr<const FadingTrace> GetTrace (void) const;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  TraceFadingPropagationLossModel (const TraceFadingPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  TraceFadingPropagationLossModel &operator = (const TraceFadingPropagationLossModel &);
+
+  virtual void DoDispose (void);
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  std::string m_traceFilename;      //!< file of the trace, or empty to generate it
+  Time m_traceLength;               //!< length of a generated trace
+  Time m_samplePeriod;              //!< sample period of a generated trace
+  double m_dopplerHz;               //!< Doppler frequency of a generated trace, in Hz
+  uint32_t m_nOscillators;          //!< number of sinusoids of a generated trace
+  Ptr<UniformRandomVariable> m_uniform;  //!< generator of the trace and of the offsets
+  mutable Ptr<const FadingTrace> m_trace;  //!< the fading trace
+  mutable PropagationCache<FadingTraceOffset> m_offsets;  //!< offset of each link
+};
+
+} // namespace ns3
+
+#endif /* TRACE_FADING_PROPAGATION_LOSS_MODEL_H */
@@ -16,12 +16,24 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/precomputed-propagation-loss-model.h"
+#include "ns3/trace-fading-propagation-loss-model.h"
+#include "ns3/fading-trace.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +448,401 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Loss model whose loss is the distance, counting its evaluations
+ */
+class DistanceCountingLossModel : public PropagationLossModel
+{
+public:
+  DistanceCountingLossModel ();
+
+  mutable uint32_t m_calls; //!< number of evaluations
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+};
+
+DistanceCountingLossModel::DistanceCountingLossModel ()
+  : m_calls (0)
+{
+}
+
+double
+DistanceCountingLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  m_calls++;
+  return txPowerDbm - a->GetDistanceFrom (b);
+}
+
+int64_t
+DistanceCountingLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (10,0,0));
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  c->SetPosition (Vector (0,20,0));
+
+  Ptr<DistanceCountingLossModel> counting = CreateObject<DistanceCountingLossModel> ();
+  Ptr<CachedPropagationLossModel> lossModel = CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetModel (counting);
+  Ptr<MatrixPropagationLossModel> next = CreateObject<MatrixPropagationLossModel> ();
+  next->SetDefaultLoss (3);
+  lossModel->SetNext (next);
+
+  double tolerance = 1e-6;
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), -13, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), -13, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 1, "The link was not cached");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), -3, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 2, "The link was not computed again for another tx power");
+  lossModel->CalcRxPower (10, b, a);
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 3, "The reverse link of an asymmetric cache was not computed");
+
+  // moving b invalidates the entry
+  b->SetPosition (Vector (20,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), -13, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 4, "The link was not computed again after a move");
+
+  // unless the move is within the position quantum
+  lossModel->SetAttribute ("PositionQuantum", DoubleValue (5));
+  b->SetPosition (Vector (24,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), -13, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 4, "The link was computed again within the position quantum");
+  b->SetPosition (Vector (26,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), -19, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 5, "The link was not computed again beyond the position quantum");
+
+  lossModel->SetAttribute ("Symmetric", BooleanValue (true));
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheSize (), 0, "The cache was not cleared");
+  lossModel->CalcRxPower (10, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, b, a), -19, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 6, "The reverse link of a symmetric cache was computed");
+
+  // the least recently used link is evicted from a bounded cache
+  lossModel->SetAttribute ("MaxSize", UintegerValue (2));
+  lossModel->CalcRxPower (10, a, c);
+  lossModel->CalcRxPower (10, b, a);
+  lossModel->CalcRxPower (10, b, c);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheSize (), 2, "The cache is not bounded");
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 8, "Got unexpected number of evaluations");
+  lossModel->CalcRxPower (10, a, b);
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 8, "The most recently used link was evicted");
+  lossModel->CalcRxPower (10, a, c);
+  NS_TEST_EXPECT_MSG_EQ (counting->m_calls, 9, "The least recently used link was not evicted");
+  Simulator::Destroy ();
+}
+
+class PrecomputedPropagationLossModelTestCase : public TestCase
+{
+public:
+  PrecomputedPropagationLossModelTestCase ();
+  virtual ~PrecomputedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Load a copy of a matrix file with a 32 bits word changed
+   * \param model the model loading the copy
+   * \param filename the matrix file
+   * \param nodes the nodes of the matrix
+   * \param offset the offset of the word
+   * \param value the new value of the word
+   * \returns the result of Load
+   */
+  bool LoadCorrupted (Ptr<PrecomputedPropagationLossModel> model, std::string filename,
+                      NodeContainer nodes, uint32_t offset, uint32_t value);
+};
+
+PrecomputedPropagationLossModelTestCase::PrecomputedPropagationLossModelTestCase ()
+  : TestCase ("Test PrecomputedPropagationLossModel")
+{
+}
+
+PrecomputedPropagationLossModelTestCase::~PrecomputedPropagationLossModelTestCase ()
+{
+}
+
+bool
+PrecomputedPropagationLossModelTestCase::LoadCorrupted (Ptr<PrecomputedPropagationLossModel> model, std::string filename,
+                                                        NodeContainer nodes, uint32_t offset, uint32_t value)
+{
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  std::string data ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+  std::memcpy (&data[offset], &value, 4);
+  std::string corrupted = CreateTempDirFilename ("path-loss-matrix-corrupted.bin");
+  std::ofstream os (corrupted.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  os.write (data.data (), data.size ());
+  os.close ();
+  return model->Load (corrupted, nodes);
+}
+
+void
+PrecomputedPropagationLossModelTestCase::DoRun (void)
+{
+  double positions[4][2] = { { 0, 0 }, { 50, 0 }, { 0, 90 }, { 300, 0 } };
+  NodeContainer nodes;
+  nodes.Create (4);
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (positions[i][0], positions[i][1], 0));
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+  Ptr<MobilityModel> other = CreateObject<ConstantPositionMobilityModel> ();
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<PrecomputedPropagationLossModel> lossModel = CreateObject<PrecomputedPropagationLossModel> ();
+  lossModel->SetAttribute ("MaxRange", DoubleValue (100));
+  lossModel->SetAttribute ("DefaultLoss", DoubleValue (500));
+  lossModel->Compute (nodes, logDistance);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNNodes (), 4, "Wrong number of nodes");
+  // 0-1 and 0-2 are within range, in both directions
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetNLinks (), 4, "Wrong number of pairs in range");
+
+  std::string filename = CreateTempDirFilename ("path-loss-matrix.bin");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->Save (filename), true, "Unable to save the matrix");
+  Ptr<PrecomputedPropagationLossModel> loaded = CreateObject<PrecomputedPropagationLossModel> ();
+  loaded->SetAttribute ("DefaultLoss", DoubleValue (500));
+  NS_TEST_EXPECT_MSG_EQ (loaded->Load (filename, NodeContainer (nodes.Get (0))), false, "Loaded a matrix of other nodes");
+  // a matrix computed for other positions of the nodes is rejected
+  nodes.Get (3)->GetObject<MobilityModel> ()->SetPosition (Vector (301, 0, 0));
+  NS_TEST_EXPECT_MSG_EQ (loaded->Load (filename, nodes), false, "Loaded a matrix of other positions");
+  nodes.Get (3)->GetObject<MobilityModel> ()->SetPosition (Vector (300, 0, 0));
+  // the rows are checked: header, 4 losses, 5 row starts, then 4 receivers
+  uint32_t rowStartOffset = 24 + 4 * 8;
+  uint32_t columnsOffset = rowStartOffset + 5 * 4;
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, columnsOffset, 7), false, "Loaded a receiver out of bounds");
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, columnsOffset, 2), false, "Loaded unsorted receivers");
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, rowStartOffset, 1), false, "Loaded a row starting after zero");
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, rowStartOffset + 4, 4), false, "Loaded decreasing rows");
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, rowStartOffset + 16, 3), false, "Loaded rows not ending at the number of pairs");
+  NS_TEST_EXPECT_MSG_EQ (LoadCorrupted (loaded, filename, nodes, columnsOffset, 1), true, "Unable to load an unchanged matrix");
+  NS_TEST_EXPECT_MSG_EQ (loaded->Load (filename, nodes), true, "Unable to load the matrix");
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetNLinks (), 4, "Wrong number of pairs loaded");
+
+  double tolerance = 1e-9;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Ptr<MobilityModel> a = nodes.Get (i)->GetObject<MobilityModel> ();
+      for (uint32_t j = 0; j < 4; ++j)
+        {
+          Ptr<MobilityModel> b = nodes.Get (j)->GetObject<MobilityModel> ();
+          double expected = 10 - 500;
+          if (i != j && a->GetDistanceFrom (b) <= 100)
+            {
+              expected = logDistance->CalcRxPower (10, a, b);
+            }
+          NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), expected, tolerance, "Got unexpected rcv power from " << i << " to " << j);
+          NS_TEST_EXPECT_MSG_EQ_TOL (loaded->CalcRxPower (10, a, b), expected, tolerance, "Got unexpected loaded rcv power from " << i << " to " << j);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, other), -490, tolerance, "Got unexpected rcv power to an unknown node");
+    }
+  loaded->Dispose ();
+  Simulator::Destroy ();
+}
+
+class TraceFadingPropagationLossModelTestCase : public TestCase
+{
+public:
+  TraceFadingPropagationLossModelTestCase ();
+  virtual ~TraceFadingPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the gain of a link, one sample after the one at time zero
+   * \param lossModel the loss model
+   * \param a the source
+   * \param b the destination
+   * \param gainDb the gain at time zero
+   */
+  void CheckNextSample (Ptr<PropagationLossModel> lossModel, Ptr<MobilityModel> a, Ptr<MobilityModel> b, double gainDb);
+};
+
+TraceFadingPropagationLossModelTestCase::TraceFadingPropagationLossModelTestCase ()
+  : TestCase ("Test TraceFadingPropagationLossModel")
+{
+}
+
+TraceFadingPropagationLossModelTestCase::~TraceFadingPropagationLossModelTestCase ()
+{
+}
+
+void
+TraceFadingPropagationLossModelTestCase::CheckNextSample (Ptr<PropagationLossModel> lossModel, Ptr<MobilityModel> a, Ptr<MobilityModel> b, double gainDb)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), std::fmod (gainDb + 1, 100), 1e-9, "The link did not move to the next sample");
+}
+
+void
+TraceFadingPropagationLossModelTestCase::DoRun (void)
+{
+  // a generated trace has a mean power of 1
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  Ptr<FadingTrace> generated = FadingTrace::Generate (2, 10000, MilliSeconds (1), 100, 16, uniform);
+  for (uint32_t row = 0; row < 2; ++row)
+    {
+      double power = 0;
+      for (uint32_t sample = 0; sample < 10000; ++sample)
+        {
+          power += std::pow (10, generated->Get (row, sample) / 10);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (power / 10000, 1, 0.2, "Wrong mean power of row " << row);
+    }
+
+  // the gain of sample i is i dB
+  Ptr<FadingTrace> trace = Create<FadingTrace> (1, 100, MilliSeconds (1));
+  for (uint32_t sample = 0; sample < 100; ++sample)
+    {
+      trace->Set (0, sample, sample);
+    }
+  std::string filename = CreateTempDirFilename ("fading-trace.bin");
+  NS_TEST_ASSERT_MSG_EQ (trace->Save (filename), true, "Unable to save the trace");
+  Ptr<const FadingTrace> loaded = FadingTrace::Load (filename);
+  NS_TEST_ASSERT_MSG_NE (loaded, 0, "Unable to load the trace");
+  NS_TEST_EXPECT_MSG_EQ (FadingTrace::Load (filename), loaded, "The trace was not shared");
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetNSamples (), 100, "Wrong number of samples");
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetSamplePeriod (), MilliSeconds (1), "Wrong sample period");
+  NS_TEST_EXPECT_MSG_EQ (loaded->Get (0, 42), 42, "Wrong sample");
+
+  // text traces hold the gains row after row
+  std::string textFilename = CreateTempDirFilename ("fading-trace.txt");
+  std::ofstream text (textFilename.c_str ());
+  text << "0 1 2\n-3.5 4 5.25\n";
+  text.close ();
+  NS_TEST_EXPECT_MSG_EQ (FadingTrace::LoadText (textFilename, 3, 3, MilliSeconds (1)), 0, "Loaded a truncated text trace");
+  Ptr<const FadingTrace> textTrace = FadingTrace::LoadText (textFilename, 2, 3, MilliSeconds (1));
+  NS_TEST_ASSERT_MSG_NE (textTrace, 0, "Unable to load the text trace");
+  NS_TEST_EXPECT_MSG_EQ (FadingTrace::LoadText (textFilename, 2, 3, MilliSeconds (1)), textTrace, "The text trace was not shared");
+  NS_TEST_EXPECT_MSG_EQ (textTrace->Get (1, 0), -3.5, "Wrong sample");
+  NS_TEST_EXPECT_MSG_EQ (textTrace->Get (1, 2), 5.25, "Wrong sample");
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> c = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<TraceFadingPropagationLossModel> lossModel = CreateObject<TraceFadingPropagationLossModel> ();
+  lossModel->SetAttribute ("TraceFilename", StringValue (filename));
+  lossModel->AssignStreams (1);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetTrace (), loaded, "The trace was not shared");
+  double ab = lossModel->CalcRxPower (0, a, b);
+  NS_TEST_EXPECT_MSG_EQ (lossModel->CalcRxPower (0, b, a), ab, "The links a-->b and b-->a have different gains");
+  double ac = lossModel->CalcRxPower (0, a, c);
+  Simulator::Schedule (MilliSeconds (1), &TraceFadingPropagationLossModelTestCase::CheckNextSample, this, lossModel, a, b, ab);
+  Simulator::Schedule (MilliSeconds (1), &TraceFadingPropagationLossModelTestCase::CheckNextSample, this, lossModel, a, c, ac);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+class BatchPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchPropagationLossModelTestCase ();
+  virtual ~BatchPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \returns a chain of models with the batched computation and a random
+   * model without it
+   */
+  Ptr<PropagationLossModel> CreateChain (void);
+};
+
+BatchPropagationLossModelTestCase::BatchPropagationLossModelTestCase ()
+  : TestCase ("Test PropagationLossModel::CalcRxPowerBatch")
+{
+}
+
+BatchPropagationLossModelTestCase::~BatchPropagationLossModelTestCase ()
+{
+}
+
+Ptr<PropagationLossModel>
+BatchPropagationLossModelTestCase::CreateChain (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  friis->SetNext (logDistance);
+  Ptr<ThreeLogDistancePropagationLossModel> threeLogDistance = CreateObject<ThreeLogDistancePropagationLossModel> ();
+  logDistance->SetNext (threeLogDistance);
+  Ptr<RandomPropagationLossModel> random = CreateObject<RandomPropagationLossModel> ();
+  threeLogDistance->SetNext (random);
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (300));
+  random->SetNext (range);
+  friis->AssignStreams (1);
+  return friis;
+}
+
+void
+BatchPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  std::vector<Ptr<MobilityModel> > b;
+  double distances[] = { 0, 0.5, 1, 50, 150, 250, 299, 301, 1000 };
+  for (uint32_t i = 0; i < sizeof (distances) / sizeof (distances[0]); i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0, distances[i], 0));
+      b.push_back (mobility);
+    }
+
+  // the same models, with the same random streams, give the same results
+  Ptr<PropagationLossModel> scalar = CreateChain ();
+  Ptr<PropagationLossModel> batch = CreateChain ();
+  std::vector<double> rxPowerDbm;
+  batch->CalcRxPowerBatch (20, a, b, rxPowerDbm);
+  NS_TEST_ASSERT_MSG_EQ (rxPowerDbm.size (), b.size (), "Got unexpected number of rcv powers");
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i], scalar->CalcRxPower (20, a, b[i]), "Got unexpected rcv power at " << distances[i] << "m");
+    }
+  NS_TEST_EXPECT_MSG_EQ (rxPowerDbm.back (), -1000, "Got unexpected rcv power beyond the range");
+
+  Ptr<FixedRssLossModel> fixed = CreateObject<FixedRssLossModel> ();
+  fixed->SetRss (-60);
+  fixed->CalcRxPowerBatch (20, a, b, rxPowerDbm);
+  for (uint32_t i = 0; i < b.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (rxPowerDbm[i], -60, "Got unexpected rcv power at " << distances[i] << "m");
+    }
+
+  b.clear ();
+  fixed->CalcRxPowerBatch (20, a, b, rxPowerDbm);
+  NS_TEST_EXPECT_MSG_EQ (rxPowerDbm.size (), 0, "Got rcv powers without receivers");
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +857,10 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PrecomputedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new TraceFadingPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -210,6 +210,19 @@ HalfDuplexIdealPhy::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noise
   m_interference.SetNoisePowerSpectralDensity (noisePsd);
 }
 
+void
+HalfDuplexIdealPhy::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  NS_LOG_FUNCTION (this << backgroundPsd);
+  m_interference.SetBackgroundPowerSpectralDensity (backgroundPsd);
+}
+
+bool
+HalfDuplexIdealPhy::SupportsBackgroundInterference (void) const
+{
+  return true;
+}
+
 void
 HalfDuplexIdealPhy::SetRate (DataRate rate)
 {
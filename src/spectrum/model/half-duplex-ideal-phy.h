@@ -107,6 +107,8 @@ public:
   Ptr<const SpectrumModel> GetRxSpectrumModel () const;
   Ptr<AntennaModel> GetRxAntenna ();
   void StartRx (Ptr<SpectrumSignalParameters> params);
+  void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+  bool SupportsBackgroundInterference (void) const;
 
 
   /**
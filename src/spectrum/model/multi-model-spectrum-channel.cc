@@ -26,6 +26,8 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/nstime.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -36,6 +38,7 @@
 #include <ns3/angles.h>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 #include "multi-model-spectrum-channel.h"
 
 
@@ -82,6 +85,10 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_maxRange (0),
+    m_cacheLinkLoss (false),
+    m_backgroundThresholdDbm (-1.0e9),
+    m_backgroundThresholdW (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +102,18 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_index = 0;
+  m_indexedPhys.clear ();
+  m_unindexedPhys.clear ();
+  m_linkLossCache.clear ();
+  for (std::map<const MobilityModel *, CourseChanges>::iterator it = m_courseChanges.begin ();
+       it != m_courseChanges.end (); ++it)
+    {
+      it->second.mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  m_courseChanges.clear ();
+  m_backgroundUpdateEvent.Cancel ();
+  m_backgroundEnergy.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +138,46 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which receivers are ignored, "
+                   "without evaluating any propagation model.  Zero means that "
+                   "all the receivers are considered.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("IndexRefreshPeriod",
+                   "The period at which the positions of the moving receivers are "
+                   "reindexed, when MaxRange is set.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&MultiModelSpectrumChannel::m_indexRefreshPeriod),
+                   MakeTimeChecker (Seconds (0), Time::Max ()))
+    .AddAttribute ("CacheLinkLoss",
+                   "If true, the single-frequency loss between two phys which are "
+                   "not moving is computed once, and computed again only after one "
+                   "of their mobility models reported a course change.  The "
+                   "PropagationLossModel must be deterministic.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_cacheLinkLoss),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BackgroundThresholdDbm",
+                   "The received power in dBm below which signals are not passed "
+                   "to the receiving PHY individually, but aggregated in its "
+                   "background interference, which is updated once every "
+                   "BackgroundUpdatePeriod.  This reduces the number of events and "
+                   "of interference calculations due to far away transmitters.  "
+                   "Signals without power, and the signals received by the PHYs "
+                   "which do not support a background interference, are always "
+                   "passed individually.  The default value disables the aggregation.",
+                   DoubleValue (-1.0e9),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::SetBackgroundThresholdDbm,
+                                       &MultiModelSpectrumChannel::GetBackgroundThresholdDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("BackgroundUpdatePeriod",
+                   "The period over which the signals aggregated in the background "
+                   "interference of a receiver are averaged.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&MultiModelSpectrumChannel::m_backgroundUpdatePeriod),
+                   MakeTimeChecker (NanoSeconds (1), Time::Max ()))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -151,6 +210,9 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 
   SpectrumModelUid_t rxSpectrumModelUid = rxSpectrumModel->GetUid ();
 
+  // the index is rebuilt at the next transmission
+  m_index = 0;
+
   // remove a previous entry of this phy if it exists
   // we need to scan for all rxSpectrumModel values since we don't
   // know which spectrum model the phy had when it was previously added
@@ -192,8 +254,8 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 
           if (rxSpectrumModelUid != txSpectrumModelUid && !txSpectrumModel->IsOrthogonal (*rxSpectrumModel))
             {
-              NS_LOG_LOGIC ("Creating converter between SpectrumModelUid " << txSpectrumModel->GetUid () << " and " << rxSpectrumModelUid);
-              SpectrumConverter converter (txSpectrumModel, rxSpectrumModel);
+              NS_LOG_LOGIC ("Adding converter between SpectrumModelUid " << txSpectrumModel->GetUid () << " and " << rxSpectrumModelUid);
+              Ptr<const SpectrumConverter> converter = SpectrumConverter::GetConverter (txSpectrumModel, rxSpectrumModel);
               std::pair<SpectrumConverterMap_t::iterator, bool> ret2;
               ret2 = txInfoIterator->second.m_spectrumConverterMap.insert (std::make_pair (rxSpectrumModelUid, converter));
               NS_ASSERT (ret2.second);
@@ -236,9 +298,9 @@ MultiModelSpectrumChannel::FindAndEventuallyAddTxSpectrumModel (Ptr<const Spectr
 
           if (rxSpectrumModelUid != txSpectrumModelUid && !txSpectrumModel->IsOrthogonal (*rxSpectrumModel))
             {
-              NS_LOG_LOGIC ("Creating converter between SpectrumModelUid " << txSpectrumModelUid << " and " << rxSpectrumModelUid);
+              NS_LOG_LOGIC ("Adding converter between SpectrumModelUid " << txSpectrumModelUid << " and " << rxSpectrumModelUid);
 
-              SpectrumConverter converter (txSpectrumModel, rxSpectrumModel);
+              Ptr<const SpectrumConverter> converter = SpectrumConverter::GetConverter (txSpectrumModel, rxSpectrumModel);
               std::pair<SpectrumConverterMap_t::iterator, bool> ret2;
               ret2 = txInfoIterator->second.m_spectrumConverterMap.insert (std::make_pair (rxSpectrumModelUid, converter));
               NS_ASSERT (ret2.second);
@@ -275,6 +337,31 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // receivers within range, by spectrum model
+  std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > > nearPhys;
+  bool culling = m_maxRange > 0 && txMobility != 0;
+  if (culling)
+    {
+      if (m_index == 0)
+        {
+          BuildIndex ();
+        }
+      std::vector<uint32_t> candidates;
+      m_index->GetCandidates (txMobility->GetPosition (), m_maxRange, candidates);
+      for (std::vector<uint32_t>::const_iterator it = candidates.begin (); it != candidates.end (); ++it)
+        {
+          Ptr<SpectrumPhy> phy = m_indexedPhys[*it];
+          if (txMobility->GetDistanceFrom (phy->GetMobility ()) <= m_maxRange)
+            {
+              nearPhys[phy->GetRxSpectrumModel ()->GetUid ()].push_back (phy);
+            }
+        }
+      for (std::vector<Ptr<SpectrumPhy> >::const_iterator it = m_unindexedPhys.begin (); it != m_unindexedPhys.end (); ++it)
+        {
+          nearPhys[(*it)->GetRxSpectrumModel ()->GetUid ()].push_back (*it);
+        }
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -282,6 +369,13 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
+      std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > >::iterator nearIterator = nearPhys.find (rxSpectrumModelUid);
+      if (culling && nearIterator == nearPhys.end ())
+        {
+          // no receiver within range
+          continue;
+        }
+
       Ptr <SpectrumValue> convertedTxPowerSpectrum;
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
@@ -297,90 +391,341 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
               continue;
             }
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+          convertedTxPowerSpectrum = rxConverterIterator->second->Convert (txParams->psd);
         }
 
+      if (culling)
+        {
+          // same order as in m_rxPhySet
+          std::vector<Ptr<SpectrumPhy> > &rxPhys = nearIterator->second;
+          std::sort (rxPhys.begin (), rxPhys.end ());
+          StartTxToRxs (txParams, txMobility, convertedTxPowerSpectrum, rxPhys);
+          continue;
+        }
 
+      std::vector<Ptr<SpectrumPhy> > rxPhys;
       for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+          rxPhys.push_back (*rxPhyIterator);
+        }
+      StartTxToRxs (txParams, txMobility, convertedTxPowerSpectrum, rxPhys);
+    }
+}
+
+void
+MultiModelSpectrumChannel::StartTxToRxs (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                         Ptr<SpectrumValue> convertedTxPowerSpectrum,
+                                         const std::vector<Ptr<SpectrumPhy> > &rxPhys)
+{
+  std::vector<double> pathLossesDb;
+  if (txMobility)
+    {
+      GetPathLossesDb (txParams, txMobility, rxPhys, pathLossesDb);
+    }
+  else
+    {
+      pathLossesDb.assign (rxPhys.size (), 0);
+    }
+  for (uint32_t i = 0; i < rxPhys.size (); i++)
+    {
+      StartTxToRx (txParams, txMobility, convertedTxPowerSpectrum, rxPhys[i], pathLossesDb[i]);
+    }
+}
+
+void
+MultiModelSpectrumChannel::StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                        Ptr<SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy,
+                                        double pathLossDb)
+{
+  if (rxPhy == txParams->txPhy)
+    {
+      return;
+    }
 
-          if ((*rxPhyIterator) != txParams->txPhy)
+  Time delay = MicroSeconds (0);
+  double pathGainLinear = 1;
+  Ptr<MobilityModel> receiverMobility = rxPhy->GetMobility ();
+
+  if (txMobility && receiverMobility)
+    {
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+      if (pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+    }
+
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+
+  if (txMobility && receiverMobility)
+    {
+      *(rxParams->psd) *= pathGainLinear;
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
+
+      if (m_backgroundThresholdW > 0 && rxPhy->SupportsBackgroundInterference ())
+        {
+          // the signals without power are not interference, but only
+          // carry information to the receiver
+          double rxPowerW = Integral (*(rxParams->psd));
+          if (rxPowerW > 0 && rxPowerW < m_backgroundThresholdW)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
-
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
+              NS_LOG_LOGIC ("aggregating a weak signal in the background interference");
+              AddToBackground (rxPhy, rxParams->psd, Simulator::Now () + delay, txParams->duration);
+              return;
             }
         }
+    }
 
+  Ptr<NetDevice> netDev = rxPhy->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, rxPhy);
     }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, rxPhy);
+    }
+}
 
+void
+MultiModelSpectrumChannel::GetPathLossesDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                            const std::vector<Ptr<SpectrumPhy> > &rxPhys,
+                                            std::vector<double> &pathLossesDb)
+{
+  pathLossesDb.assign (rxPhys.size (), 0);
+
+  // the links whose loss is not cached, and their cache entry if they
+  // are static
+  std::vector<uint32_t> links;
+  std::vector<LinkLoss *> cachedLinks;
+  std::vector<Ptr<MobilityModel> > rxMobilities;
+  bool txStatic = m_cacheLinkLoss && CalculateDistance (txMobility->GetVelocity (), Vector ()) == 0;
+  for (uint32_t i = 0; i < rxPhys.size (); i++)
+    {
+      Ptr<MobilityModel> rxMobility = rxPhys[i]->GetMobility ();
+      if (rxPhys[i] == txParams->txPhy || rxMobility == 0)
+        {
+          continue;
+        }
+      LinkLoss *link = 0;
+      if (txStatic && CalculateDistance (rxMobility->GetVelocity (), Vector ()) == 0)
+        {
+          uint32_t txCourseChanges = GetCourseChanges (txMobility);
+          uint32_t rxCourseChanges = GetCourseChanges (rxMobility);
+          link = &m_linkLossCache[std::make_pair (PeekPointer (txParams->txPhy), PeekPointer (rxPhys[i]))];
+          if (link->txCourseChanges == txCourseChanges && link->rxCourseChanges == rxCourseChanges)
+            {
+              pathLossesDb[i] = link->lossDb;
+              continue;
+            }
+          link->txCourseChanges = txCourseChanges;
+          link->rxCourseChanges = rxCourseChanges;
+        }
+      links.push_back (i);
+      cachedLinks.push_back (link);
+      rxMobilities.push_back (rxMobility);
+    }
+
+  std::vector<double> propagationGainsDb;
+  if (m_propagationLoss)
+    {
+      m_propagationLoss->CalcRxPowerBatch (0, txMobility, rxMobilities, propagationGainsDb);
+    }
+  else
+    {
+      propagationGainsDb.assign (rxMobilities.size (), 0);
+    }
+  for (uint32_t k = 0; k < links.size (); k++)
+    {
+      double lossDb = CalcPathLossDb (txParams, txMobility, rxPhys[links[k]], rxMobilities[k], propagationGainsDb[k]);
+      pathLossesDb[links[k]] = lossDb;
+      if (cachedLinks[k] != 0)
+        {
+          cachedLinks[k]->lossDb = lossDb;
+        }
+    }
+}
+
+double
+MultiModelSpectrumChannel::CalcPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                           Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> rxMobility,
+                                           double propagationGainDb) const
+{
+  double pathLossDb = 0;
+  if (txParams->txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (m_propagationLoss)
+    {
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+  return pathLossDb;
+}
+
+uint32_t
+MultiModelSpectrumChannel::GetCourseChanges (Ptr<MobilityModel> mobility)
+{
+  std::map<const MobilityModel *, CourseChanges>::iterator it = m_courseChanges.find (PeekPointer (mobility));
+  if (it == m_courseChanges.end ())
+    {
+      // count from 1, so that new cache entries are out of date
+      CourseChanges courseChanges;
+      courseChanges.mobility = mobility;
+      courseChanges.count = 1;
+      it = m_courseChanges.insert (std::make_pair (PeekPointer (mobility), courseChanges)).first;
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  return it->second.count;
+}
+
+void
+MultiModelSpectrumChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::map<const MobilityModel *, CourseChanges>::iterator it = m_courseChanges.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_courseChanges.end ());
+  it->second.count++;
+}
+
+void
+MultiModelSpectrumChannel::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_index = Create<MobilityGrid> (m_maxRange, m_indexRefreshPeriod);
+  m_indexedPhys.clear ();
+  m_unindexedPhys.clear ();
+  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator phyIt = rxInfoIterator->second.m_rxPhySet.begin ();
+           phyIt != rxInfoIterator->second.m_rxPhySet.end ();
+           ++phyIt)
+        {
+          Ptr<MobilityModel> mobility = (*phyIt)->GetMobility ();
+          if (mobility == 0)
+            {
+              m_unindexedPhys.push_back (*phyIt);
+            }
+          else
+            {
+              m_index->Add (mobility, m_indexedPhys.size ());
+              m_indexedPhys.push_back (*phyIt);
+            }
+        }
+    }
+}
+
+void
+MultiModelSpectrumChannel::SetBackgroundThresholdDbm (double thresholdDbm)
+{
+  NS_LOG_FUNCTION (this << thresholdDbm);
+  m_backgroundThresholdDbm = thresholdDbm;
+  // 0 for the default value, which disables the aggregation
+  m_backgroundThresholdW = std::pow (10.0, (thresholdDbm - 30) / 10.0);
+}
+
+double
+MultiModelSpectrumChannel::GetBackgroundThresholdDbm (void) const
+{
+  return m_backgroundThresholdDbm;
+}
+
+void
+MultiModelSpectrumChannel::AddToBackground (Ptr<SpectrumPhy> rxPhy, Ptr<const SpectrumValue> rxPsd, Time start, Time duration)
+{
+  NS_LOG_FUNCTION (this << rxPhy << start << duration);
+  if (!m_backgroundUpdateEvent.IsRunning ())
+    {
+      m_backgroundPeriodStart = Simulator::Now ();
+      m_backgroundUpdateEvent = Simulator::Schedule (m_backgroundUpdatePeriod, &MultiModelSpectrumChannel::UpdateBackground, this);
+    }
+  std::deque<Ptr<SpectrumValue> > &energy = m_backgroundEnergy[rxPhy];
+  if (!energy.empty () && energy.front ()->GetSpectrumModelUid () != rxPsd->GetSpectrumModelUid ())
+    {
+      // the receiver changed its spectrum model
+      energy.clear ();
+    }
+  // energy[k] is the energy of the k-th period from the current one
+  Time end = start + duration;
+  Time periodStart = m_backgroundPeriodStart;
+  for (uint32_t k = 0; periodStart < end; ++k, periodStart += m_backgroundUpdatePeriod)
+    {
+      if (k == energy.size ())
+        {
+          energy.push_back (Create<SpectrumValue> (rxPsd->GetSpectrumModel ()));
+        }
+      Time overlap = std::min (end, periodStart + m_backgroundUpdatePeriod) - std::max (start, periodStart);
+      if (overlap.IsStrictlyPositive ())
+        {
+          energy[k]->AddProduct (*rxPsd, overlap.GetSeconds ());
+        }
+    }
+}
+
+void
+MultiModelSpectrumChannel::UpdateBackground (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::map<Ptr<SpectrumPhy>, std::deque<Ptr<SpectrumValue> > >::iterator it = m_backgroundEnergy.begin ();
+  while (it != m_backgroundEnergy.end ())
+    {
+      if (it->second.empty ())
+        {
+          // no weak signal during the period: clear the background and
+          // forget the receiver until its next weak signal
+          it->first->SetBackgroundPowerSpectralDensity (0);
+          m_backgroundEnergy.erase (it++);
+          continue;
+        }
+      NS_LOG_LOGIC ("background of " << it->first << " known for " << it->second.size () << " periods");
+      Ptr<SpectrumValue> backgroundPsd = it->second.front ();
+      it->second.pop_front ();
+      (*backgroundPsd) /= m_backgroundUpdatePeriod.GetSeconds ();
+      it->first->SetBackgroundPowerSpectralDensity (backgroundPsd);
+      ++it;
+    }
+  if (!m_backgroundEnergy.empty ())
+    {
+      m_backgroundPeriodStart = Simulator::Now ();
+      m_backgroundUpdateEvent = Simulator::Schedule (m_backgroundUpdatePeriod, &MultiModelSpectrumChannel::UpdateBackground, this);
+    }
 }
 
 void
@@ -456,6 +801,13 @@ MultiModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
   m_propagationDelay = delay;
 }
 
+Ptr<PropagationLossModel>
+MultiModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 MultiModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
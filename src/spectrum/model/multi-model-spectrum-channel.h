@@ -27,8 +27,12 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-grid.h>
+#include <ns3/event-id.h>
+#include <deque>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -37,7 +41,7 @@ namespace ns3 {
  * \ingroup spectrum
  * Container: SpectrumModelUid_t, SpectrumConverter
  */
-typedef std::map<SpectrumModelUid_t, SpectrumConverter> SpectrumConverterMap_t;
+typedef std::map<SpectrumModelUid_t, Ptr<const SpectrumConverter> > SpectrumConverterMap_t;
 
 /**
  * \ingroup spectrum
@@ -102,6 +106,32 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+
+ *
+ * Two optional mechanisms reduce the cost of a transmission to many
+ * receivers:
+ *
+ * - if the MaxRange attribute is set, the receivers further than this
+ *   distance from the transmitter are ignored without evaluating any
+ *   model.  They are looked up in a ns3::MobilityGrid, so the mobility
+ *   models must notify all their course changes.  A range matching
+ *   MaxLossDb can be obtained with PropagationLossModel::CalcMaxDistance,
+ *   after accounting for the largest antenna gains;
+ *
+ * - if the CacheLinkLoss attribute is true, the loss computed from the
+ *   antenna models and the PropagationLossModel between two SpectrumPhy
+ *   which are not moving is reused until one of their mobility models
+ *   reports a course change.  This requires a deterministic
+ *   PropagationLossModel and antenna models which do not change;
+ *
+ * - if the BackgroundThresholdDbm attribute is set, the signals received
+ *   with a non-zero power below this threshold by a SpectrumPhy which
+ *   supports a background interference are not notified to the receiver
+ *   individually.  Their energy is split between the BackgroundUpdatePeriod
+ *   periods which they overlap and accumulated for each receiver, and its
+ *   average over each period is passed to
+ *   SpectrumPhy::SetBackgroundPowerSpectralDensity at the end of the
+ *   period, as the background interference of the next period.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -127,6 +157,12 @@ public:
   virtual uint32_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
+  /**
+   * Get the single-frequency propagation loss model.
+   * \returns a pointer to the propagation loss model.
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+
   /**
    * Get the frequency-dependent propagation loss model.
    * \returns a pointer to the propagation loss model.
@@ -158,6 +194,128 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Compute the propagation to the receivers of a spectrum model and
+   * schedule the receptions.
+   *
+   * \param txParams the signal parameters of the transmission
+   * \param txMobility the mobility model of the transmitter
+   * \param convertedTxPowerSpectrum the transmitted PSD, in the spectrum
+   *        model of the receivers
+   * \param rxPhys the receivers
+   */
+  void StartTxToRxs (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                     Ptr<SpectrumValue> convertedTxPowerSpectrum,
+                     const std::vector<Ptr<SpectrumPhy> > &rxPhys);
+
+  /**
+   * Compute the propagation to a receiver and schedule the reception.
+   *
+   * \param txParams the signal parameters of the transmission
+   * \param txMobility the mobility model of the transmitter
+   * \param convertedTxPowerSpectrum the transmitted PSD, in the spectrum
+   *        model of the receiver
+   * \param rxPhy the receiver
+   * \param pathLossDb the single-frequency loss of the link, in dB
+   */
+  void StartTxToRx (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                    Ptr<SpectrumValue> convertedTxPowerSpectrum, Ptr<SpectrumPhy> rxPhy,
+                    double pathLossDb);
+
+  /**
+   * Compute the single-frequency loss of the links to several receivers,
+   * or get them from the cache.  The losses which are not cached are
+   * computed with a single call to PropagationLossModel::CalcRxPowerBatch.
+   *
+   * \param txParams the signal parameters of the transmission
+   * \param txMobility the mobility model of the transmitter
+   * \param rxPhys the receivers
+   * \param pathLossesDb the loss of each link in dB, including the antenna
+   *        gains, or 0 for the transmitter and the receivers without a
+   *        mobility model
+   */
+  void GetPathLossesDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                        const std::vector<Ptr<SpectrumPhy> > &rxPhys,
+                        std::vector<double> &pathLossesDb);
+
+  /**
+   * Compute the single-frequency loss of a link.
+   *
+   * \param txParams the signal parameters of the transmission
+   * \param txMobility the mobility model of the transmitter
+   * \param rxPhy the receiver
+   * \param rxMobility the mobility model of the receiver
+   * \param propagationGainDb the gain of the PropagationLossModel, in dB
+   * \return the loss in dB, including the antenna gains
+   */
+  double CalcPathLossDb (Ptr<SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                         Ptr<SpectrumPhy> rxPhy, Ptr<MobilityModel> rxMobility,
+                         double propagationGainDb) const;
+
+  /**
+   * \param mobility a mobility model
+   * \return the number of course changes of the mobility model since the
+   *         channel first saw it
+   */
+  uint32_t GetCourseChanges (Ptr<MobilityModel> mobility);
+
+  /**
+   * CourseChange trace sink of the mobility models of the cached links.
+   * \param mobility the mobility model
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * Build the index of the positions of the receivers.
+   */
+  void BuildIndex (void);
+
+  /**
+   * Set the BackgroundThresholdDbm attribute.
+   *
+   * \param thresholdDbm the threshold, in dBm
+   */
+  void SetBackgroundThresholdDbm (double thresholdDbm);
+
+  /**
+   * Get the BackgroundThresholdDbm attribute.
+   *
+   * \return the threshold, in dBm
+   */
+  double GetBackgroundThresholdDbm (void) const;
+
+  /**
+   * Accumulate a weak signal in the background interference of a receiver,
+   * in each of the update periods which it overlaps.
+   *
+   * \param rxPhy the receiver
+   * \param rxPsd the received PSD
+   * \param start the start of the reception
+   * \param duration the duration of the signal
+   */
+  void AddToBackground (Ptr<SpectrumPhy> rxPhy, Ptr<const SpectrumValue> rxPsd, Time start, Time duration);
+
+  /**
+   * Pass to the receivers the average of the background interference of
+   * the last update period, and start a new period.
+   */
+  void UpdateBackground (void);
+
+  /// A cached link loss
+  struct LinkLoss
+  {
+    double lossDb;                //!< the loss in dB
+    uint32_t txCourseChanges;     //!< course changes of the transmitter when the loss was computed
+    uint32_t rxCourseChanges;     //!< course changes of the receiver when the loss was computed
+  };
+
+  /// A mobility model of a cached link
+  struct CourseChanges
+  {
+    Ptr<MobilityModel> mobility;  //!< the mobility model
+    uint32_t count;               //!< the number of course changes
+  };
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -201,6 +359,79 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum distance of the receivers, 0 if unlimited.
+   */
+  double m_maxRange;
+
+  /**
+   * Refresh period of the index of the receiver positions.
+   */
+  Time m_indexRefreshPeriod;
+
+  /**
+   * Index of the positions of the receivers which have a mobility model,
+   * identified by their position in m_indexedPhys.
+   */
+  Ptr<MobilityGrid> m_index;
+
+  /**
+   * Receivers in the index.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_indexedPhys;
+
+  /**
+   * Receivers without a mobility model, which get every transmission.
+   */
+  std::vector<Ptr<SpectrumPhy> > m_unindexedPhys;
+
+  /**
+   * Whether the loss of the links between static phys is cached.
+   */
+  bool m_cacheLinkLoss;
+
+  /**
+   * Cached losses, by transmitting and receiving phy.
+   */
+  std::map<std::pair<const SpectrumPhy *, const SpectrumPhy *>, LinkLoss> m_linkLossCache;
+
+  /**
+   * Course changes of the mobility models of the cached links.
+   */
+  std::map<const MobilityModel *, CourseChanges> m_courseChanges;
+
+  /**
+   * Received power [dBm] below which the signals are aggregated in the
+   * background interference of the receivers.
+   */
+  double m_backgroundThresholdDbm;
+
+  /**
+   * The background threshold in W, or 0 if the aggregation is disabled.
+   */
+  double m_backgroundThresholdW;
+
+  /**
+   * Period over which the background interference is averaged.
+   */
+  Time m_backgroundUpdatePeriod;
+
+  /**
+   * Energy spectral density of the weak signals of the current period and
+   * of the following ones which they overlap, by receiver.
+   */
+  std::map<Ptr<SpectrumPhy>, std::deque<Ptr<SpectrumValue> > > m_backgroundEnergy;
+
+  /**
+   * Start of the current period of the background interference.
+   */
+  Time m_backgroundPeriodStart;
+
+  /**
+   * End of the current period of the background interference.
+   */
+  EventId m_backgroundUpdateEvent;
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
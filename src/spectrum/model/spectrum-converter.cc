@@ -21,7 +21,9 @@
 #include <ns3/spectrum-converter.h>
 #include <ns3/assert.h>
 #include <ns3/log.h>
+#include <ns3/system-mutex.h>
 #include <algorithm>
+#include <map>
 
 
 
@@ -81,8 +83,31 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
   NS_ASSERT ( *(fvvf->GetSpectrumModel ()) == *m_fromSpectrumModel);
 
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
-
+  size_t nFrom = m_fromSpectrumModel->GetNumBands ();
+  if (nFrom == 0)
+    {
+      return tvvf;
+    }
+  const double *from = &(*fvvf->ConstValuesBegin ());
   Values::iterator tvit = tvvf->ValuesBegin ();
+
+  // signals usually occupy a small part of the source bands: the rows
+  // whose coefficients all apply to source bands out of [first, last)
+  // are zero and are not computed.  The column indexes of a row are
+  // sorted.
+  size_t first = 0;
+  while (first < nFrom && from[first] == 0)
+    {
+      first++;
+    }
+  size_t last = nFrom;
+  while (last > first && from[last - 1] == 0)
+    {
+      last--;
+    }
+
+  const double *matrix = m_conversionMatrix.empty () ? 0 : &m_conversionMatrix[0];
+  const size_t *colInd = m_conversionColInd.empty () ? 0 : &m_conversionColInd[0];
   size_t i = 0; // Index of conversion coefficient
 
   for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin ();
@@ -90,11 +115,15 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
        ++convIt)
     {
       double sum = 0;
-      while (i < *convIt)
+      size_t end = *convIt;
+      if (i < end && colInd[i] < last && colInd[end - 1] >= first)
         {
-          sum += (*fvvf)[m_conversionColInd.at (i)] * m_conversionMatrix.at (i);
-          i++;
+          for (; i < end; i++)
+            {
+              sum += from[colInd[i]] * matrix[i];
+            }
         }
+      i = end;
       *tvit = sum;
       ++tvit;
     }
@@ -102,6 +131,30 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
   return tvvf;
 }
 
+Ptr<const SpectrumConverter>
+SpectrumConverter::GetConverter (Ptr<const SpectrumModel> fromSpectrumModel,
+                                 Ptr<const SpectrumModel> toSpectrumModel)
+{
+  NS_LOG_FUNCTION (fromSpectrumModel << toSpectrumModel);
+  // the uids of the spectrum models are never reused, and the converters
+  // keep their spectrum models alive
+  typedef std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, Ptr<const SpectrumConverter> > ConverterMap;
+  static SystemMutex mutex;
+  static ConverterMap converters;
+
+  CriticalSection cs (mutex);
+  std::pair<ConverterMap::iterator, bool> ret;
+  ret = converters.insert (std::make_pair (std::make_pair (fromSpectrumModel->GetUid (), toSpectrumModel->GetUid ()),
+                                           Ptr<const SpectrumConverter> ()));
+  if (ret.second)
+    {
+      NS_LOG_LOGIC ("Creating converter between SpectrumModelUid " << fromSpectrumModel->GetUid ()
+                                                                   << " and " << toSpectrumModel->GetUid ());
+      ret.first->second = Create<SpectrumConverter> (fromSpectrumModel, toSpectrumModel);
+    }
+  return ret.first->second;
+}
+
 
 
 
@@ -65,6 +65,22 @@ public:
    */
   Ptr<SpectrumValue> Convert (Ptr<const SpectrumValue> vvf) const;
 
+  /**
+   * Get the converter between two SpectrumModels.
+   *
+   * The converters are built the first time they are requested, and are
+   * then shared by all the users (e.g., all the channels) converting
+   * between the same SpectrumModels.  This method can be called from
+   * several threads.
+   *
+   * @param fromSpectrumModel the SpectrumModel to convert from
+   * @param toSpectrumModel the SpectrumModel to convert to
+   *
+   * @return the shared converter
+   */
+  static Ptr<const SpectrumConverter> GetConverter (Ptr<const SpectrumModel> fromSpectrumModel,
+                                                    Ptr<const SpectrumModel> toSpectrumModel);
+
 
 private:
   /**
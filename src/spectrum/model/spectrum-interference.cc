@@ -35,6 +35,7 @@ SpectrumInterference::SpectrumInterference ()
     m_rxSignal (0),
     m_allSignals (0),
     m_noise (0),
+    m_background (0),
     m_errorModel (0)
 {
   NS_LOG_FUNCTION (this);
@@ -63,6 +64,7 @@ SpectrumInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_background = 0;
   m_errorModel = 0;
   Object::DoDispose ();
 }
@@ -131,7 +133,14 @@ SpectrumInterference::ConditionallyEvaluateChunk ()
   NS_LOG_LOGIC ("if condition: " << condition);
   if (condition)
     {
-      SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
+      SpectrumValue interf = *m_allSignals;
+      interf -= *m_rxSignal;
+      interf += *m_noise;
+      if (m_background)
+        {
+          interf += *m_background;
+        }
+      SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
       NS_LOG_LOGIC ("calling m_errorModel->EvaluateChunk (sinr, duration)");
       m_errorModel->EvaluateChunk (sinr, duration);
@@ -148,6 +157,16 @@ SpectrumInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noi
   // we'll now create a zeroed SpectrumValue using the same
   // SpectrumModel which is being specified for the noise.
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_background = 0;
+}
+
+void
+SpectrumInterference::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  NS_LOG_FUNCTION (this << backgroundPsd);
+  ConditionallyEvaluateChunk ();
+  m_background = backgroundPsd;
+  m_lastChangeTime = Now ();
 }
 
 void
@@ -107,6 +107,16 @@ public:
    */
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
+  /**
+   * Set the Power Spectral Density of the background interference, i.e.,
+   * the signals which the channel aggregated instead of delivering them
+   * individually.  It is added to the noise until it is set again.
+   *
+   * @param backgroundPsd the background Power Spectral Density in power
+   * units per Hz, or 0 for none
+   */
+  void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+
 
 protected:
   void DoDispose ();
@@ -143,6 +153,8 @@ private:
 
   Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
 
+  Ptr<const SpectrumValue> m_background; //!< Background interference spectral power density, if any
+
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
   Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
@@ -24,6 +24,7 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/spectrum-channel.h>
 #include <ns3/log.h>
+#include <ns3/fatal-error.h>
 
 namespace ns3 {
 
@@ -52,5 +53,18 @@ SpectrumPhy::~SpectrumPhy ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+SpectrumPhy::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  NS_LOG_FUNCTION (this << backgroundPsd);
+  NS_FATAL_ERROR ("this SpectrumPhy does not support a background interference");
+}
+
+bool
+SpectrumPhy::SupportsBackgroundInterference (void) const
+{
+  return false;
+}
+
 
 } // namespace
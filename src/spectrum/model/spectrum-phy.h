@@ -112,6 +112,27 @@ public:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params) = 0;
 
+  /**
+   * Set the power spectral density of the background interference, i.e.,
+   * the average of the weak signals which the channel aggregates instead
+   * of notifying them with StartRx.  The background replaces the previous
+   * one, and is to be added to the noise.  It is only called if
+   * SupportsBackgroundInterference returns true.
+   *
+   * @param backgroundPsd the power spectral density of the background
+   * interference, in the SpectrumModel of the receiver, or 0 for none
+   */
+  virtual void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+
+  /**
+   * The channels only aggregate the weak signals of the receivers which
+   * handle the background interference, and pass them individually to the
+   * others.  The default implementation returns false.
+   *
+   * @return true if SetBackgroundPowerSpectralDensity is implemented
+   */
+  virtual bool SupportsBackgroundInterference (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -409,6 +409,26 @@ public:
    */
   SpectrumValue& operator= (double rhs);
 
+  /**
+   * Add the product of a SpectrumValue and a scalar to *this, component
+   * by component, without building the product as a temporary
+   * SpectrumValue: a.AddProduct (x, s) is equivalent to a += x * s.
+   *
+   * @param x the SpectrumValue
+   * @param s the scalar
+   */
+  void AddProduct (const SpectrumValue& x, double s);
+
+  /**
+   * Add the component by component product of two SpectrumValues to
+   * *this, without building the product as a temporary SpectrumValue:
+   * a.AddProduct (x, y) is equivalent to a += x * y.
+   *
+   * @param x the first factor
+   * @param y the second factor
+   */
+  void AddProduct (const SpectrumValue& x, const SpectrumValue& y);
+
 
 
   /**
@@ -497,6 +517,17 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   *
+   *
+   * @param lhs the first factor
+   * @param rhs the second factor
+   *
+   * @return the value of the integral of the product of the arguments,
+   * \f$\int_F g(f) h(f) df  \f$, computed without building the product
+   */
+  friend double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -619,6 +650,16 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+/**
+ * Integral of the component by component product of two SpectrumValues,
+ * without building the product as a temporary SpectrumValue:
+ * Integral (x, y) is equivalent to Integral (x * y).
+ *
+ * @param lhs the first factor
+ * @param rhs the second factor, in the same SpectrumModel
+ * @return the integral of the product over the bands of the SpectrumModel
+ */
+double Integral (const SpectrumValue& lhs, const SpectrumValue& rhs);
 
 
 } // namespace ns3
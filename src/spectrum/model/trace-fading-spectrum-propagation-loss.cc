@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include "trace-fading-spectrum-propagation-loss.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceFadingSpectrumPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceFadingSpectrumPropagationLossModel);
+
+TraceFadingSpectrumPropagationLossModel::TraceFadingSpectrumPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_uniform = CreateObject<UniformRandomVariable> ();
+}
+
+TraceFadingSpectrumPropagationLossModel::~TraceFadingSpectrumPropagationLossModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+TraceFadingSpectrumPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceFadingSpectrumPropagationLossModel")
+    .SetParent<SpectrumPropagationLossModel> ()
+    .SetGroupName ("Spectrum")
+    .AddConstructor<TraceFadingSpectrumPropagationLossModel> ()
+    .AddAttribute ("TraceFilename",
+                   "The binary file of the fading trace, or empty to generate the trace.",
+                   StringValue (""),
+                   MakeStringAccessor (&TraceFadingSpectrumPropagationLossModel::m_traceFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("TraceLength",
+                   "The length of a generated trace.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TraceFadingSpectrumPropagationLossModel::m_traceLength),
+                   MakeTimeChecker ())
+    .AddAttribute ("SamplePeriod",
+                   "The sample period of a generated trace.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TraceFadingSpectrumPropagationLossModel::m_samplePeriod),
+                   MakeTimeChecker ())
+    .AddAttribute ("DopplerFrequencyHz",
+                   "The maximum Doppler frequency of a generated trace, in Hz.",
+                   DoubleValue (10),
+                   MakeDoubleAccessor (&TraceFadingSpectrumPropagationLossModel::m_dopplerHz),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("NumberOfOscillators",
+                   "The number of sinusoids of a generated trace.",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&TraceFadingSpectrumPropagationLossModel::m_nOscillators),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NumberOfRows",
+                   "The number of independent rows of a generated trace: 1 for flat fading, "
+                   "or the number of sub-bands with independent fading.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TraceFadingSpectrumPropagationLossModel::m_nRows),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+void
+TraceFadingSpectrumPropagationLossModel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_uniform = 0;
+  m_trace = 0;
+  m_offsets.Clear ();
+  SpectrumPropagationLossModel::DoDispose ();
+}
+
+Ptr<const FadingTrace>
+TraceFadingSpectrumPropagationLossModel::GetTrace (void) const
+{
+  if (m_trace == 0)
+    {
+      m_trace = FadingTrace::Get (m_traceFilename, m_nRows, m_traceLength, m_samplePeriod, m_dopplerHz, m_nOscillators, m_uniform);
+    }
+  return m_trace;
+}
+
+Ptr<SpectrumValue>
+TraceFadingSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                       Ptr<const MobilityModel> a,
+                                                                       Ptr<const MobilityModel> b) const
+{
+  Ptr<const FadingTrace> trace = GetTrace ();
+  uint32_t nRows = trace->GetNRows ();
+  uint32_t nSamples = trace->GetNSamples ();
+  Ptr<FadingTraceOffset> offset = m_offsets.GetPathData (a, b, 0);
+  if (offset == 0)
+    {
+      offset = Create<FadingTraceOffset> ();
+      offset->row = m_uniform->GetInteger (0, nRows - 1);
+      offset->sample = m_uniform->GetInteger (0, nSamples - 1);
+      m_offsets.AddPathData (offset, a, b, 0);
+    }
+  uint64_t sample = Simulator::Now ().GetTimeStep () / trace->GetSamplePeriod ().GetTimeStep ();
+  sample = (offset->sample + sample) % nSamples;
+
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
+  if (nRows == 1)
+    {
+      (*rxPsd) *= std::pow (10.0, trace->Get (0, sample) / 10);
+      return rxPsd;
+    }
+  // the bands take the rows in turn from the row of the link, so each
+  // row used is converted to linear units once
+  uint32_t nBands = rxPsd->GetSpectrumModel ()->GetNumBands ();
+  std::vector<double> gains (std::min (nRows, nBands));
+  uint32_t row = offset->row;
+  for (uint32_t k = 0; k < gains.size (); ++k)
+    {
+      gains[k] = std::pow (10.0, trace->Get (row, sample) / 10);
+      if (++row == nRows)
+        {
+          row = 0;
+        }
+    }
+  uint32_t k = 0;
+  for (Values::iterator vit = rxPsd->ValuesBegin (); vit != rxPsd->ValuesEnd (); ++vit)
+    {
+      *vit *= gains[k];
+      if (++k == gains.size ())
+        {
+          k = 0;
+        }
+    }
+  return rxPsd;
+}
+
+int64_t
+TraceFadingSpectrumPropagationLossModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uniform->SetStream (stream);
+  return 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_FADING_SPECTRUM_PROPAGATION_LOSS_H
+#define TRACE_FADING_SPECTRUM_PROPAGATION_LOSS_H
+
+#include <string>
+#include <ns3/nstime.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/propagation-cache.h>
+#include <ns3/fading-trace.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Fast fading read from a trace shared by all the links
+ *
+ * The spectrum counterpart of TraceFadingPropagationLossModel: the fading
+ * gain of a link is read from a FadingTrace at a random offset drawn when
+ * the link is first used.  Band i of the signal is faded by row
+ * (r + i) modulo the number of rows of the trace, where r is a random row
+ * of the link, so a trace with a single row models flat fading and a
+ * trace with one row per sub-band models frequency selective fading.
+ * The trace is loaded from the binary file given by the TraceFilename
+ * attribute, and shared by all the models using the same file, or
+ * generated with NumberOfRows independent Jakes processes.  The gains are
+ * read from the trace converted once to linear units, so each band costs
+ * a single lookup.
+ */
+class TraceFadingSpectrumPropagationLossModel : public SpectrumPropagationLossModel
+{
+public:
+  TraceFadingSpectrumPropagationLossModel ();
+  virtual ~TraceFadingSpectrumPropagationLossModel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \returns the fading trace, loaded or generated if necessary
+   */
+  Ptr<const FadingTrace> GetTrace (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  virtual void DoDispose ();
+  virtual Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                           Ptr<const MobilityModel> a,
+                                                           Ptr<const MobilityModel> b) const;
+
+  std::string m_traceFilename;      //!< file of the trace, or empty to generate it
+  Time m_traceLength;               //!< length of a generated trace
+  Time m_samplePeriod;              //!< sample period of a generated trace
+  double m_dopplerHz;               //!< Doppler frequency of a generated trace, in Hz
+  uint32_t m_nOscillators;          //!< number of sinusoids of a generated trace
+  uint32_t m_nRows;                 //!< number of rows of a generated trace
+  Ptr<UniformRandomVariable> m_uniform;  //!< generator of the trace and of the offsets
+  mutable Ptr<const FadingTrace> m_trace;  //!< the fading trace
+  mutable PropagationCache<FadingTraceOffset> m_offsets;  //!< offset of each link
+};
+
+} // namespace ns3
+
+#endif /* TRACE_FADING_SPECTRUM_PROPAGATION_LOSS_H */
@@ -0,0 +1,472 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+#include <cmath>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/boolean.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum
+ *
+ * SpectrumPhy counting the signals it receives
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * \param model the rx spectrum model
+   */
+  CountingSpectrumPhy (Ptr<const SpectrumModel> model);
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+  virtual void SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd);
+  virtual bool SupportsBackgroundInterference (void) const;
+
+  bool m_supportsBackground; ///< whether to support a background interference
+  uint32_t m_received; ///< number of signals received
+  uint32_t m_backgroundUpdates; ///< number of background updates
+  Ptr<const SpectrumValue> m_background; ///< last background
+  Time m_lastBackgroundUpdate; ///< time of the last background update
+
+private:
+  Ptr<const SpectrumModel> m_model; ///< rx spectrum model
+  Ptr<MobilityModel> m_mobility;    ///< mobility model
+};
+
+CountingSpectrumPhy::CountingSpectrumPhy (Ptr<const SpectrumModel> model)
+  : m_supportsBackground (true),
+    m_received (0),
+    m_backgroundUpdates (0),
+    m_model (model)
+{
+}
+
+void
+CountingSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+CountingSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+CountingSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+CountingSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+CountingSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_model;
+}
+
+Ptr<AntennaModel>
+CountingSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_received++;
+}
+
+void
+CountingSpectrumPhy::SetBackgroundPowerSpectralDensity (Ptr<const SpectrumValue> backgroundPsd)
+{
+  m_backgroundUpdates++;
+  m_background = backgroundPsd;
+  m_lastBackgroundUpdate = Simulator::Now ();
+}
+
+bool
+CountingSpectrumPhy::SupportsBackgroundInterference (void) const
+{
+  return m_supportsBackground;
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * Propagation loss model counting its evaluations for each receiver
+ */
+class CountingLossModel : public PropagationLossModel
+{
+public:
+  mutable std::map<Ptr<MobilityModel>, uint32_t> m_calls; ///< evaluations by receiver
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+};
+
+double
+CountingLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  m_calls[b]++;
+  return txPowerDbm - 10;
+}
+
+int64_t
+CountingLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * Check the receiver culling and the link loss cache of
+ * MultiModelSpectrumChannel.
+ *
+ * A static transmitter sends three signals, at 1s, 2s and 4s.  Receiver 1
+ * and 2 are within MaxRange, receiver 3 is beyond it and receiver 4 has
+ * no mobility model.  Receiver 2 is moved at 3s, so its loss is computed
+ * again for the last signal, while the loss to receiver 1 is computed once.
+ */
+class MultiModelSpectrumChannelTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MultiModelSpectrumChannelTestCase::MultiModelSpectrumChannelTestCase ()
+  : TestCase ("Check receiver culling and link loss cache")
+{
+}
+
+void
+MultiModelSpectrumChannelTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.41e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+  channel->SetAttribute ("CacheLinkLoss", BooleanValue (true));
+  Ptr<CountingLossModel> loss = CreateObject<CountingLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  double positions[4][2] = { { 0, 0 }, { 10, 0 }, { 0, 50 }, { 1000, 0 } };
+  std::vector<Ptr<CountingSpectrumPhy> > phys;
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> (model);
+      if (i < 4)
+        {
+          Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (positions[i][0], positions[i][1], 0));
+          phy->SetMobility (mobility);
+        }
+      channel->AddRx (phy);
+      phys.push_back (phy);
+    }
+
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (model);
+  (*params->psd) = 1.0;
+  params->duration = MilliSeconds (1);
+  params->txPhy = phys[0];
+
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Schedule (Seconds (2), &MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Schedule (Seconds (3), &MobilityModel::SetPosition, phys[2]->GetMobility (), Vector (0, 60, 0));
+  Simulator::Schedule (Seconds (4), &MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Run ();
+
+  uint32_t received[5] = { 0, 3, 3, 0, 3 };
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (phys[i]->m_received, received[i], "Wrong number of signals received by phy " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls[phys[1]->GetMobility ()], 1, "The loss to phy 1 was not cached");
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls[phys[2]->GetMobility ()], 2, "The loss to phy 2 was not recomputed after it moved");
+  NS_TEST_EXPECT_MSG_EQ (loss->m_calls[phys[3]->GetMobility ()], 0, "The loss to phy 3 was computed beyond MaxRange");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * Check the aggregation of the weak signals in the background interference
+ * by MultiModelSpectrumChannel.
+ *
+ * A transmitter sends a 1 ms signal at 1s and a 0.5 ms signal at 1.0005s.
+ * Receiver 1 is near and receives them both, receiver 2 is far away and
+ * gets their average power over the first update period as background
+ * interference, which is then cleared at the end of the second period.
+ */
+class MultiModelSpectrumChannelBackgroundTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelBackgroundTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the background of the far receiver after the first period.
+   * \param phy the far receiver
+   * \param txPsd the transmitted PSD
+   * \param loss the propagation loss model
+   */
+  void CheckBackground (Ptr<CountingSpectrumPhy> phy, Ptr<const SpectrumValue> txPsd,
+                        Ptr<PropagationLossModel> loss);
+};
+
+MultiModelSpectrumChannelBackgroundTestCase::MultiModelSpectrumChannelBackgroundTestCase ()
+  : TestCase ("Check the aggregation of weak signals in the background interference")
+{
+}
+
+void
+MultiModelSpectrumChannelBackgroundTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.41e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("BackgroundThresholdDbm", DoubleValue (-80));
+  channel->SetAttribute ("BackgroundUpdatePeriod", TimeValue (MilliSeconds (1)));
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  // -46.7 dBm at 10 m, -106.7 dBm at 1 km
+  double positions[3] = { 0, 10, 1000 };
+  std::vector<Ptr<CountingSpectrumPhy> > phys;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> (model);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (positions[i], 0, 0));
+      phy->SetMobility (mobility);
+      channel->AddRx (phy);
+      phys.push_back (phy);
+    }
+
+  // 1 W
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (model);
+  (*params->psd) = 1.0;
+  (*params->psd) /= Integral (*params->psd);
+  params->duration = MilliSeconds (1);
+  params->txPhy = phys[0];
+  Ptr<SpectrumSignalParameters> shortParams = params->Copy ();
+  shortParams->duration = MicroSeconds (500);
+
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Schedule (MicroSeconds (1000500), &MultiModelSpectrumChannel::StartTx, channel, shortParams);
+  Simulator::Schedule (MicroSeconds (1001500), &MultiModelSpectrumChannelBackgroundTestCase::CheckBackground, this, phys[2], params->psd, loss);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (phys[1]->m_received, 2, "The near signals were not received");
+  NS_TEST_EXPECT_MSG_EQ (phys[1]->m_backgroundUpdates, 0, "Unexpected background for the near receiver");
+  NS_TEST_EXPECT_MSG_EQ (phys[2]->m_received, 0, "The weak signals were received individually");
+  NS_TEST_EXPECT_MSG_EQ (phys[2]->m_backgroundUpdates, 2, "Wrong number of background updates");
+  NS_TEST_EXPECT_MSG_EQ ((phys[2]->m_background == 0), true, "The background was not cleared");
+  NS_TEST_EXPECT_MSG_EQ (phys[2]->m_lastBackgroundUpdate, MicroSeconds (1002000), "Wrong time of the last background update");
+
+  Simulator::Destroy ();
+}
+
+void
+MultiModelSpectrumChannelBackgroundTestCase::CheckBackground (Ptr<CountingSpectrumPhy> phy, Ptr<const SpectrumValue> txPsd,
+                                                              Ptr<PropagationLossModel> loss)
+{
+  NS_TEST_ASSERT_MSG_EQ (phy->m_backgroundUpdates, 1, "The background was not updated after the first period");
+  NS_TEST_ASSERT_MSG_EQ ((phy->m_background != 0), true, "No background after the first period");
+  Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  double gain = std::pow (10.0, loss->CalcRxPower (0, txMobility, phy->GetMobility ()) / 10);
+  // 1 ms of the first signal and 0.5 ms of the second one
+  SpectrumValue expected = (*txPsd) * gain * 1.5;
+  for (uint32_t i = 0; i < expected.GetSpectrumModel ()->GetNumBands (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL ((*phy->m_background)[i], expected[i], expected[i] * 1e-9, "Wrong background in band " << i);
+    }
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * Check that the energy of a weak signal longer than the update period of
+ * the background interference is split between the periods it overlaps.
+ *
+ * A transmitter sends a 0.1 ms signal at 1s, which starts the first
+ * period, and a 4 ms signal at 1.0005s.  The far receiver gets the average
+ * power of each period as the background of the next one, and the far
+ * receiver which does not support a background interference receives the
+ * two signals individually.
+ */
+class MultiModelSpectrumChannelLongBackgroundTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelLongBackgroundTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the background of the far receiver.
+   * \param phy the far receiver
+   * \param rxPsd the received PSD of the signals
+   * \param factor the expected background, relative to rxPsd
+   */
+  void CheckBackground (Ptr<CountingSpectrumPhy> phy, SpectrumValue rxPsd, double factor);
+};
+
+MultiModelSpectrumChannelLongBackgroundTestCase::MultiModelSpectrumChannelLongBackgroundTestCase ()
+  : TestCase ("Check the background interference of a signal longer than the update period")
+{
+}
+
+void
+MultiModelSpectrumChannelLongBackgroundTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  freqs.push_back (2.4e9);
+  freqs.push_back (2.41e9);
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("BackgroundThresholdDbm", DoubleValue (-80));
+  channel->SetAttribute ("BackgroundUpdatePeriod", TimeValue (MilliSeconds (1)));
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  channel->AddPropagationLossModel (loss);
+
+  // -106.7 dBm at 1 km
+  Vector positions[3] = { Vector (0, 0, 0), Vector (1000, 0, 0), Vector (0, 1000, 0) };
+  std::vector<Ptr<CountingSpectrumPhy> > phys;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> (model);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (positions[i]);
+      phy->SetMobility (mobility);
+      channel->AddRx (phy);
+      phys.push_back (phy);
+    }
+  phys[2]->m_supportsBackground = false;
+
+  // 1 W
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (model);
+  (*params->psd) = 1.0;
+  (*params->psd) /= Integral (*params->psd);
+  params->duration = MicroSeconds (100);
+  params->txPhy = phys[0];
+  Ptr<SpectrumSignalParameters> longParams = params->Copy ();
+  longParams->duration = MilliSeconds (4);
+  double gain = std::pow (10.0, loss->CalcRxPower (0, phys[0]->GetMobility (), phys[1]->GetMobility ()) / 10);
+  SpectrumValue rxPsd = (*params->psd) * gain;
+
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannel::StartTx, channel, params);
+  Simulator::Schedule (MicroSeconds (1000500), &MultiModelSpectrumChannel::StartTx, channel, longParams);
+  // 0.1 ms of the first signal and 0.5 ms of the second one, then 3 whole
+  // periods and the last 0.5 ms of the second signal
+  double factors[6] = { 0.6, 1, 1, 1, 0.5, 0 };
+  for (uint32_t i = 0; i < 6; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (1001500 + 1000 * i), &MultiModelSpectrumChannelLongBackgroundTestCase::CheckBackground,
+                           this, phys[1], rxPsd, factors[i]);
+    }
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (phys[1]->m_received, 0, "The weak signals were received individually");
+  NS_TEST_EXPECT_MSG_EQ (phys[1]->m_backgroundUpdates, 6, "Wrong number of background updates");
+  NS_TEST_EXPECT_MSG_EQ (phys[2]->m_received, 2, "The signals of the receiver without background were lost");
+  NS_TEST_EXPECT_MSG_EQ (phys[2]->m_backgroundUpdates, 0, "Unexpected background for the receiver without background");
+
+  Simulator::Destroy ();
+}
+
+void
+MultiModelSpectrumChannelLongBackgroundTestCase::CheckBackground (Ptr<CountingSpectrumPhy> phy, SpectrumValue rxPsd, double factor)
+{
+  if (factor == 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((phy->m_background == 0), true, "The background was not cleared");
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ ((phy->m_background != 0), true, "No background");
+  for (uint32_t i = 0; i < rxPsd.GetSpectrumModel ()->GetNumBands (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL ((*phy->m_background)[i], rxPsd[i] * factor, rxPsd[i] * 1e-9, "Wrong background in band " << i);
+    }
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * MultiModelSpectrumChannel test suite
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  AddTestCase (new MultiModelSpectrumChannelTestCase, TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelBackgroundTestCase, TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelLongBackgroundTestCase, TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
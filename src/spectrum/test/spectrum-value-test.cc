@@ -76,6 +76,60 @@ SpectrumValueTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup spectrum
+ *
+ * Check that Integral (x, y) matches Integral (x * y), with bands of
+ * different widths.
+ */
+class SpectrumValueIntegralTestCase : public TestCase
+{
+public:
+  SpectrumValueIntegralTestCase ();
+  virtual ~SpectrumValueIntegralTestCase ();
+  virtual void DoRun (void);
+};
+
+SpectrumValueIntegralTestCase::SpectrumValueIntegralTestCase ()
+  : TestCase ("Integral of a product")
+{
+}
+
+SpectrumValueIntegralTestCase::~SpectrumValueIntegralTestCase ()
+{
+}
+
+void
+SpectrumValueIntegralTestCase::DoRun (void)
+{
+  Bands bands;
+  double fl = 1e9;
+  for (uint32_t i = 0; i < 7; ++i)
+    {
+      BandInfo band;
+      band.fl = fl;
+      band.fh = fl + 1e5 * (i + 1);
+      band.fc = (band.fl + band.fh) / 2;
+      bands.push_back (band);
+      fl = band.fh;
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (bands);
+  SpectrumValue x (model);
+  SpectrumValue y (model);
+  for (uint32_t i = 0; i < 7; ++i)
+    {
+      x[i] = 1e-12 * (i + 1);
+      y[i] = (i % 2 == 0) ? 0.5 + i : -0.25 * i;
+    }
+  double expected = Integral (x * y);
+  NS_TEST_EXPECT_MSG_EQ_TOL (Integral (x, y), expected, std::abs (expected) * 1e-12, "Wrong integral of x * y");
+  NS_TEST_EXPECT_MSG_EQ_TOL (Integral (y, x), expected, std::abs (expected) * 1e-12, "Wrong integral of y * x");
+  SpectrumValue ones (model);
+  ones = 1;
+  NS_TEST_EXPECT_MSG_EQ_TOL (Integral (x, ones), Integral (x), Integral (x) * 1e-12, "Wrong integral of x * 1");
+}
+
+
 
 
 
@@ -223,6 +277,14 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv9b, v9, "tv9b =  doubleValue * v1"), TestCase::QUICK);
   AddTestCase (new SpectrumValueTestCase (tv10b, v10, "tv10b = doubleValue div v1"), TestCase::QUICK);
 
+  SpectrumValue tv11 (f), tv12 (f);
+  tv11 = v3;
+  tv11.AddProduct (v1, v2);
+  tv12 = v3;
+  tv12.AddProduct (v1, doubleValue);
+  AddTestCase (new SpectrumValueTestCase (tv11, v3 + v5, "tv11 = v3 + v1 * v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (tv12, v3 + v9, "tv12 = v3 + v1 * doubleValue"), TestCase::QUICK);
+
 
 
 
@@ -241,6 +303,8 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   tv1rs3 = v1 >> 3;
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
+  AddTestCase (new SpectrumValueIntegralTestCase, TestCase::QUICK);
+
 
 }
 
@@ -328,6 +392,15 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 //   NS_LOG_LOGIC(*res);
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
+  // the rows which only get zero source bands are skipped
+  Ptr<SpectrumValue> v2c = Create<SpectrumValue> (sof2);
+  (*v2c)[5] = 6;
+  (*v2c)[6] = 3;
+  res = SpectrumConverter::GetConverter (sof2, sof1)->Convert (v2c);
+  SpectrumValue t21c (sof1);
+  t21c[2] = 6 * 0.5 + 3 * 0.25;
+  AddTestCase (new SpectrumValueTestCase (t21c, *res, ""), TestCase::QUICK);
+
 
 }
 
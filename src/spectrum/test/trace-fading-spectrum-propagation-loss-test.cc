@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/fading-trace.h>
+#include <ns3/trace-fading-spectrum-propagation-loss.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Check the gains of TraceFadingSpectrumPropagationLossModel
+ *
+ * The gain of row r and sample s of the trace is s + r / 2 dB, so the row
+ * and the sample of a gain can be told from its value.  The bands of a
+ * signal must be faded by consecutive rows of the same sample, and by the
+ * next sample one sample period later.
+ */
+class TraceFadingSpectrumPropagationLossTestCase : public TestCase
+{
+public:
+  TraceFadingSpectrumPropagationLossTestCase ();
+  virtual ~TraceFadingSpectrumPropagationLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the gains of the bands of a signal
+   * \param model the fading model
+   * \param txPsd the transmitted signal
+   * \param a the source
+   * \param b the destination
+   * \param first the expected gain of the first band, in dB, or a negative value if unknown
+   * \returns the gain of the first band, in dB
+   */
+  double CheckGains (Ptr<TraceFadingSpectrumPropagationLossModel> model, Ptr<const SpectrumValue> txPsd,
+                     Ptr<MobilityModel> a, Ptr<MobilityModel> b, double first);
+  /**
+   * Check that a link moved to the next sample
+   * \param model the fading model
+   * \param txPsd the transmitted signal
+   * \param a the source
+   * \param b the destination
+   * \param previous the gain of the first band at the previous sample, in dB
+   */
+  void CheckNextSample (Ptr<TraceFadingSpectrumPropagationLossModel> model, Ptr<const SpectrumValue> txPsd,
+                        Ptr<MobilityModel> a, Ptr<MobilityModel> b, double previous);
+};
+
+TraceFadingSpectrumPropagationLossTestCase::TraceFadingSpectrumPropagationLossTestCase ()
+  : TestCase ("Check the gains of TraceFadingSpectrumPropagationLossModel")
+{
+}
+
+TraceFadingSpectrumPropagationLossTestCase::~TraceFadingSpectrumPropagationLossTestCase ()
+{
+}
+
+double
+TraceFadingSpectrumPropagationLossTestCase::CheckGains (Ptr<TraceFadingSpectrumPropagationLossModel> model, Ptr<const SpectrumValue> txPsd,
+                                                        Ptr<MobilityModel> a, Ptr<MobilityModel> b, double first)
+{
+  Ptr<SpectrumValue> rxPsd = model->CalcRxPowerSpectralDensity (txPsd, a, b);
+  double gainDb = 10 * std::log10 ((*rxPsd)[0]);
+  if (first >= 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (gainDb, first, 1e-9, "Wrong gain of the first band");
+    }
+  // the rows of the other bands follow the one of the first band
+  double sample = std::floor (gainDb + 1e-6);
+  uint32_t row = static_cast<uint32_t> (std::floor ((gainDb - sample) * 2 + 0.5));
+  for (uint32_t i = 1; i < 3; ++i)
+    {
+      double expected = sample + ((row + i) % 2) / 2.0;
+      NS_TEST_EXPECT_MSG_EQ_TOL (10 * std::log10 ((*rxPsd)[i]), expected, 1e-9, "Wrong gain of band " << i);
+    }
+  return gainDb;
+}
+
+void
+TraceFadingSpectrumPropagationLossTestCase::CheckNextSample (Ptr<TraceFadingSpectrumPropagationLossModel> model, Ptr<const SpectrumValue> txPsd,
+                                                             Ptr<MobilityModel> a, Ptr<MobilityModel> b, double previous)
+{
+  CheckGains (model, txPsd, a, b, std::fmod (previous + 1, 100));
+}
+
+void
+TraceFadingSpectrumPropagationLossTestCase::DoRun (void)
+{
+  Ptr<FadingTrace> trace = Create<FadingTrace> (2, 100, MilliSeconds (1));
+  for (uint32_t row = 0; row < 2; ++row)
+    {
+      for (uint32_t sample = 0; sample < 100; ++sample)
+        {
+          trace->Set (row, sample, sample + row / 2.0);
+        }
+    }
+  std::string filename = CreateTempDirFilename ("spectrum-fading-trace.bin");
+  NS_TEST_ASSERT_MSG_EQ (trace->Save (filename), true, "Unable to save the trace");
+
+  std::vector<double> frequencies;
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      frequencies.push_back (1e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> spectrumModel = Create<SpectrumModel> (frequencies);
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (spectrumModel);
+  (*txPsd) = 1;
+
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<TraceFadingSpectrumPropagationLossModel> model = CreateObject<TraceFadingSpectrumPropagationLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (filename));
+  model->AssignStreams (1);
+  NS_TEST_EXPECT_MSG_EQ (model->GetTrace (), FadingTrace::Load (filename), "The trace was not shared");
+  double ab = CheckGains (model, txPsd, a, b, -1);
+  Simulator::Schedule (MilliSeconds (1), &TraceFadingSpectrumPropagationLossTestCase::CheckNextSample, this, model, txPsd, a, b, ab);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief TraceFadingSpectrumPropagationLossModel test suite
+ */
+class TraceFadingSpectrumPropagationLossTestSuite : public TestSuite
+{
+public:
+  TraceFadingSpectrumPropagationLossTestSuite ();
+};
+
+TraceFadingSpectrumPropagationLossTestSuite::TraceFadingSpectrumPropagationLossTestSuite ()
+  : TestSuite ("trace-fading-spectrum-propagation-loss", UNIT)
+{
+  AddTestCase (new TraceFadingSpectrumPropagationLossTestCase, TestCase::QUICK);
+}
+
+static TraceFadingSpectrumPropagationLossTestSuite g_traceFadingSpectrumPropagationLossTestSuite;
@@ -0,0 +1,332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure how fast wifi networks of increasing sizes are simulated, with
+// the YansWifiPhy and the SpectrumWifiPhy.  Three scenarios are available:
+//
+//  - bss: one AP and n stations around it, each station sending to the AP;
+//  - obss: n stations split among bssCount overlapping BSSs on the same
+//    channel, whose APs are bssDistance meters apart;
+//  - adhoc: n ad hoc stations on a grid, each one sending to the next one.
+//
+// The senders share an offered load of a few Mb/s, so that the number of
+// frames sent does not grow with the number of stations, while the number
+// of receptions does.  One line of comma-separated values is printed for
+// each run:
+//
+//   scenario,phy,stations,events,wallMs,eventsPerSec,peakRssKb,throughputMbps
+//
+// where events is the number of events scheduled during the run, wallMs
+// the wall clock time of Simulator::Run, peakRssKb the peak resident set
+// size of the process so far (it never decreases, so run one configuration
+// per process to get the footprint of each one) and throughputMbps the
+// rate of the data received by the MAC layers of the receivers.
+//
+// The program returns 1 if a run is slower than minEventsPerSec or
+// maxWallMs, so that it can check for performance regressions:
+//
+//   ./waf --run "perf-wifi --stations=10,100,1000 --minEventsPerSec=200000"
+//
+// These checks are manual only: test.py does not run this program, since
+// the thresholds depend on the host and on the build profile.
+//
+
+#include <iostream>
+#include <sstream>
+#include <sys/resource.h>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+static uint64_t g_rxBytes = 0;          //!< Number of bytes received
+
+/**
+ * Count the bytes received by a MAC layer
+ * \param p the packet
+ */
+static void
+MacRx (Ptr<const Packet> p)
+{
+  g_rxBytes += p->GetSize ();
+}
+
+/**
+ * Does nothing: scheduled to learn the number of events scheduled so far
+ */
+static void
+Nothing (void)
+{
+}
+
+/**
+ * Split a comma-separated list
+ * \param list the list
+ * \returns the items of the list
+ */
+static std::vector<std::string>
+Split (const std::string &list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/**
+ * Send a constant rate flow of packets from a device to another one
+ * \param from the sending device
+ * \param to the receiving device
+ * \param rate the rate of the flow
+ * \param start the start time of the flow
+ * \param stop the stop time of the flow
+ */
+static void
+AddFlow (Ptr<NetDevice> from, Ptr<NetDevice> to, DataRate rate, Time start, Time stop)
+{
+  PacketSocketAddress socket;
+  socket.SetSingleDevice (from->GetIfIndex ());
+  socket.SetPhysicalAddress (to->GetAddress ());
+  socket.SetProtocol (1);
+
+  OnOffHelper onoff ("ns3::PacketSocketFactory", Address (socket));
+  onoff.SetConstantRate (rate, 1000);
+  ApplicationContainer apps = onoff.Install (from->GetNode ());
+  apps.Start (start);
+  apps.Stop (stop);
+}
+
+/**
+ * The result of a run
+ */
+struct Result
+{
+  uint64_t events;        //!< number of events scheduled
+  int64_t wallMs;         //!< wall clock time of the run, in milliseconds
+  long peakRssKb;         //!< peak resident set size, in kilobytes
+  double throughput;      //!< received throughput, in Mb/s
+};
+
+/**
+ * Simulate a scenario
+ * \param scenario the scenario (bss, obss or adhoc)
+ * \param phyType the phy (yans or spectrum)
+ * \param nStations the number of stations, APs excluded
+ * \param bssCount the number of BSSs of the obss scenario
+ * \param bssDistance the distance between the APs of the obss scenario
+ * \param load the offered load, in Mb/s
+ * \param duration the duration of the traffic
+ * \returns the result of the run
+ */
+static Result
+Run (std::string scenario, std::string phyType, uint32_t nStations,
+     uint32_t bssCount, double bssDistance, double load, Time duration)
+{
+  if (scenario != "obss")
+    {
+      bssCount = (scenario == "bss") ? 1 : 0;
+    }
+  NS_ABORT_MSG_IF (nStations == 0, "At least one station is needed");
+  NS_ABORT_MSG_IF (scenario == "obss" && (bssCount == 0 || nStations < bssCount),
+                   "Each BSS needs at least one station");
+
+  NodeContainer aps;
+  NodeContainer stas;
+  aps.Create (bssCount);
+  stas.Create (nStations);
+  NodeContainer nodes (aps, stas);
+
+  // the APs are on a line, their stations on a circle around them and
+  // the ad hoc stations on a grid
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < bssCount; i++)
+    {
+      positions->Add (Vector (i * bssDistance, 0, 0));
+    }
+  uint32_t side = std::ceil (std::sqrt (nStations));
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      if (bssCount > 0)
+        {
+          double angle = 2 * M_PI * i / nStations;
+          positions->Add (Vector ((i % bssCount) * bssDistance + 5 * std::cos (angle), 5 * std::sin (angle), 0));
+        }
+      else
+        {
+          positions->Add (Vector ((i % side) * 5.0, (i / side) * 5.0, 0));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HtMcs7"),
+                                "ControlMode", StringValue ("HtMcs0"));
+
+  YansWifiPhyHelper yansPhy = YansWifiPhyHelper::Default ();
+  SpectrumWifiPhyHelper spectrumPhy = SpectrumWifiPhyHelper::Default ();
+  WifiPhyHelper *phy;
+  if (phyType == "yans")
+    {
+      YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+      yansPhy.SetChannel (channel.Create ());
+      phy = &yansPhy;
+    }
+  else if (phyType == "spectrum")
+    {
+      Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+      channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+      spectrumPhy.SetChannel (channel);
+      phy = &spectrumPhy;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown phy " << phyType);
+    }
+
+  NetDeviceContainer apDevices;
+  NetDeviceContainer staDevices;
+  WifiMacHelper mac;
+  if (bssCount == 0)
+    {
+      mac.SetType ("ns3::AdhocWifiMac");
+      staDevices = wifi.Install (*phy, mac, stas);
+    }
+  else
+    {
+      // station i belongs to the BSS i % bssCount
+      for (uint32_t i = 0; i < bssCount + nStations; i++)
+        {
+          std::ostringstream oss;
+          oss << "bss-" << i % bssCount;
+          Ssid ssid (oss.str ());
+          if (i < bssCount)
+            {
+              mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+              apDevices.Add (wifi.Install (*phy, mac, aps.Get (i)));
+            }
+          else
+            {
+              mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+              staDevices.Add (wifi.Install (*phy, mac, stas.Get (i - bssCount)));
+            }
+        }
+    }
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (nodes);
+
+  // leave one second to the stations to associate
+  Time start = Seconds (1);
+  DataRate rate (static_cast<uint64_t> (load * 1e6 / nStations));
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Ptr<NetDevice> to = (bssCount > 0) ? apDevices.Get (i % bssCount) : staDevices.Get ((i + 1) % nStations);
+      AddFlow (staDevices.Get (i), to, rate, start, start + duration);
+    }
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx", MakeCallback (&MacRx));
+  Simulator::Stop (start + duration);
+
+  g_rxBytes = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  Result result;
+  result.wallMs = clock.End ();
+  // the uid of an event is the number of events scheduled before it
+  result.events = Simulator::Schedule (Seconds (0), &Nothing).GetUid ();
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  result.peakRssKb = usage.ru_maxrss;
+  result.throughput = g_rxBytes * 8 / duration.GetSeconds () / 1e6;
+  Simulator::Destroy ();
+  return result;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string scenarios = "bss,obss,adhoc";
+  std::string phys = "yans,spectrum";
+  std::string stations = "10,100";
+  uint32_t bssCount = 4;
+  double bssDistance = 20;
+  double load = 10;
+  double duration = 2;
+  double minEventsPerSec = 0;
+  int64_t maxWallMs = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("scenarios", "Comma-separated list of scenarios (bss, obss, adhoc)", scenarios);
+  cmd.AddValue ("phys", "Comma-separated list of phys (yans, spectrum)", phys);
+  cmd.AddValue ("stations", "Comma-separated list of numbers of stations", stations);
+  cmd.AddValue ("bssCount", "Number of BSSs of the obss scenario", bssCount);
+  cmd.AddValue ("bssDistance", "Distance between the APs of the obss scenario, in meters", bssDistance);
+  cmd.AddValue ("load", "Offered load shared by all the senders, in Mb/s", load);
+  cmd.AddValue ("duration", "Duration of the traffic, in seconds", duration);
+  cmd.AddValue ("minEventsPerSec", "Fail if a run simulates fewer events per wall clock second (0 to disable)", minEventsPerSec);
+  cmd.AddValue ("maxWallMs", "Fail if a run lasts longer, in milliseconds (0 to disable)", maxWallMs);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::string> scenarioList = Split (scenarios);
+  std::vector<std::string> phyList = Split (phys);
+  std::vector<std::string> stationList = Split (stations);
+
+  bool failed = false;
+  std::cout << "scenario,phy,stations,events,wallMs,eventsPerSec,peakRssKb,throughputMbps" << std::endl;
+  for (std::vector<std::string>::const_iterator s = scenarioList.begin (); s != scenarioList.end (); ++s)
+    {
+      for (std::vector<std::string>::const_iterator p = phyList.begin (); p != phyList.end (); ++p)
+        {
+          for (std::vector<std::string>::const_iterator n = stationList.begin (); n != stationList.end (); ++n)
+            {
+              uint32_t nStations = std::atoi (n->c_str ());
+              Result r = Run (*s, *p, nStations, bssCount, bssDistance, load, Seconds (duration));
+              double eventsPerSec = r.wallMs > 0 ? r.events * 1000.0 / r.wallMs : 0;
+              std::cout << *s << "," << *p << "," << nStations << "," << r.events << ","
+                        << r.wallMs << "," << static_cast<uint64_t> (eventsPerSec) << ","
+                        << r.peakRssKb << "," << r.throughput << std::endl;
+              if ((minEventsPerSec > 0 && r.wallMs > 0 && eventsPerSec < minEventsPerSec)
+                  || (maxWallMs > 0 && r.wallMs > maxWallMs))
+                {
+                  std::cerr << "Performance threshold missed by " << *s << "/" << *p
+                            << "/" << nStations << std::endl;
+                  failed = true;
+                }
+            }
+        }
+    }
+  return failed ? 1 : 0;
+}
@@ -21,6 +21,7 @@
 #ifndef INTERFERENCE_HELPER_H
 #define INTERFERENCE_HELPER_H
 
+#include <map>
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
 #include "error-rate-model.h"
@@ -211,50 +212,51 @@ private:
 private:
   /**
    * Noise and Interference (thus Ni) event.
+   *
+   * A NiChange records the start or the end of an event, along with the
+   * total power received from all the events right after the change, so
+   * that the power at any time is found without summing the changes made
+   * since the last garbage collection.
    */
   class NiChange
   {
 public:
     /**
-     * Create a NiChange at the given time and the amount of NI change.
+     * Create a NiChange with the given power after the change.
      *
-     * \param time time of the event
-     * \param delta the power
+     * \param power the power after the change (W)
+     * \param event the event which starts or ends
      */
-    NiChange (Time time, double delta);
+    NiChange (double power, Ptr<Event> event);
     /**
-     * Return the event time.
+     * Return the power
      *
-     * \return the event time.
+     * \return the power
      */
-    Time GetTime (void) const;
+    double GetPower (void) const;
     /**
-     * Return the power
+     * Add a given amount of power.
      *
-     * \return the power
+     * \param power the power to be added to the existing value
      */
-    double GetDelta (void) const;
+    void AddPower (double power);
     /**
-     * Compare the event time of two NiChange objects (a < o).
+     * Return the event causes the corresponding NI change
      *
-     * \param o
-     * \return true if a < o.time, false otherwise
+     * \return the event
      */
-    bool operator < (const NiChange& o) const;
+    Ptr<Event> GetEvent (void) const;
 
 
 private:
-    Time m_time; ///< time
-    double m_delta; ///< delta
+    double m_power; ///< power after the change
+    Ptr<Event> m_event; ///< event
   };
   /**
-   * typedef for a vector of NiChanges
-   */
-  typedef std::vector <NiChange> NiChanges;
-  /**
-   * typedef for a list of Events
+   * typedef for a multimap of NiChanges, ordered by time. The changes at
+   * the same time are kept in the order they were added.
    */
-  typedef std::list<Ptr<Event> > Events;
+  typedef std::multimap<Time, NiChange> NiChanges;
 
   /**
    * Append the given Event.
@@ -265,12 +267,13 @@ private:
   /**
    * Calculate noise and interference power in W.
    *
-   * \param event
-   * \param ni
+   * \param event the event being received
+   * \param first [out] the change at the start of the event
+   * \param end [out] the change following the one at the end of the event
    *
-   * \return noise and interference power
+   * \return noise and interference power at the start of the event
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first, NiChanges::const_iterator *end) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -299,37 +302,48 @@ private:
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the change at the start of the event
+   * \param end the change following the one at the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges::const_iterator first, NiChanges::const_iterator end) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the change at the start of the event
+   * \param end the change following the one at the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges::const_iterator first, NiChanges::const_iterator end) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
   uint8_t m_numRxAntennas; /**< the number of RX antennas in the corresponding receiver */
-  /// Experimental: needed for energy duration calculation
+  /**
+   * The changes of the noise and interference power. The changes which
+   * occurred before the current time are garbage-collected when no event
+   * is being received, and replaced with a single change holding the
+   * power at the current time.
+   */
   NiChanges m_niChanges;
-  double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  /**
+   * \param moment the time
+   * \returns an iterator to the last change which is not later than moment
+   */
+  NiChanges::iterator GetPreviousPosition (Time moment);
   /**
    * Add NiChange to the list at the appropriate position.
    *
-   * \param change
+   * \param moment the time of the change
+   * \param change the change
+   * \returns an iterator to the added change
    */
-  void AddNiChangeEvent (NiChange change);
+  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
 };
 
 } //namespace ns3
@@ -645,10 +645,19 @@ MacLow::StartTransmission (Ptr<const Packet> packet,
    * QapScheduler has taken access to the channel from
    * one of the Edca of the QAP.
    */
-  m_currentPacket = packet->Copy ();
-  // remove the priority tag attached, if any
+  // remove the priority tag attached, if any. The packet is not modified
+  // afterwards, hence it is copied only if it carries such a tag.
   SocketPriorityTag priorityTag;
-  m_currentPacket->RemovePacketTag (priorityTag);
+  if (packet->PeekPacketTag (priorityTag))
+    {
+      Ptr<Packet> copy = packet->Copy ();
+      copy->RemovePacketTag (priorityTag);
+      m_currentPacket = copy;
+    }
+  else
+    {
+      m_currentPacket = packet;
+    }
   m_currentHdr = *hdr;
   m_currentDca = dca;
   CancelAllEvents ();
@@ -1876,16 +1885,16 @@ MacLow::SendDataPacket (void)
         }
     }
   m_currentHdr.SetDuration (duration);
-  Ptr <Packet> packet = m_currentPacket->Copy ();
   if (m_ampdu)
     {
+      // the MPDUs are taken from the aggregate queue by ForwardDown
       NS_ASSERT (m_currentHdr.IsQosData ());
+      ForwardDown (m_currentPacket, &m_currentHdr, m_currentTxVector);
+      return;
     }
-  else
-    {
-      packet->AddHeader (m_currentHdr);
-      AddWifiMacTrailer (packet);
-    }
+  Ptr <Packet> packet = m_currentPacket->Copy ();
+  packet->AddHeader (m_currentHdr);
+  AddWifiMacTrailer (packet);
 
   ForwardDown (packet, &m_currentHdr, m_currentTxVector);
 }
@@ -2086,16 +2095,16 @@ MacLow::SendDataAfterCts (Mac48Address source, Time duration)
   duration = std::max (duration, newDuration);
   NS_ASSERT (duration >= MicroSeconds (0));
   m_currentHdr.SetDuration (duration);
-  Ptr <Packet> packet = m_currentPacket->Copy ();
   if (m_ampdu)
     {
+      // the MPDUs are taken from the aggregate queue by ForwardDown
       NS_ASSERT (m_currentHdr.IsQosData ());
+      ForwardDown (m_currentPacket, &m_currentHdr, m_currentTxVector);
+      return;
     }
-  else
-    {
-      packet->AddHeader (m_currentHdr);
-      AddWifiMacTrailer (packet);
-    }
+  Ptr <Packet> packet = m_currentPacket->Copy ();
+  packet->AddHeader (m_currentHdr);
+  AddWifiMacTrailer (packet);
 
   ForwardDown (packet, &m_currentHdr, m_currentTxVector);
 }
@@ -2740,7 +2749,6 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
               uint16_t blockAckSize = 0;
               bool aggregated = false;
               int i = 0;
-              Ptr<Packet> aggPacket = newPacket->Copy ();
 
               if (!hdr.IsBlockAckReq ())
                 {
@@ -2759,7 +2767,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                     {
                       NS_LOG_DEBUG ("Adding packet with Sequence number " << currentSequenceNumber << " to A-MPDU, packet size = " << newPacket->GetSize () << ", A-MPDU size = " << currentAggregatedPacket->GetSize ());
                       i++;
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (packet, peekedHdr));
                     }
                 }
               else if (hdr.IsBlockAckReq ())
@@ -2792,7 +2800,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                       tempPacket = PerformMsduAggregation (peekedPacket, &peekedHdr, &tstamp, currentAggregatedPacket, blockAckSize);
                       if (tempPacket != 0)  //MSDU aggregation
                         {
-                          peekedPacket = tempPacket->Copy ();
+                          peekedPacket = tempPacket;
                         }
                     }
                 }
@@ -2823,14 +2831,12 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                     }
 
                   newPacket = peekedPacket->Copy ();
-                  Ptr<Packet> aggPacket = newPacket->Copy ();
-
                   newPacket->AddHeader (peekedHdr);
                   AddWifiMacTrailer (newPacket);
                   aggregated = edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
                   if (aggregated)
                     {
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (peekedPacket, peekedHdr));
                       if (i == 1 && hdr.IsQosData ())
                         {
                           if (!m_txParams.MustSendRts ())
@@ -2890,7 +2896,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                                   tempPacket = PerformMsduAggregation (peekedPacket, &peekedHdr, &tstamp, currentAggregatedPacket, blockAckSize);
                                   if (tempPacket != 0) //MSDU aggregation
                                     {
-                                      peekedPacket = tempPacket->Copy ();
+                                      peekedPacket = tempPacket;
                                     }
                                 }
                             }
@@ -2917,7 +2923,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                               tempPacket = PerformMsduAggregation (peekedPacket, &peekedHdr, &tstamp, currentAggregatedPacket, blockAckSize);
                               if (tempPacket != 0) //MSDU aggregation
                                 {
-                                  peekedPacket = tempPacket->Copy ();
+                                  peekedPacket = tempPacket;
                                 }
                             }
                         }
@@ -2934,8 +2940,7 @@ MacLow::AggregateToAmpdu (Ptr<const Packet> packet, const WifiMacHeader hdr)
                     {
                       newPacket = packet->Copy ();
                       peekedHdr = hdr;
-                      Ptr<Packet> aggPacket = newPacket->Copy ();
-                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (aggPacket, peekedHdr));
+                      m_aggregateQueue[tid]->Enqueue (Create<WifiMacQueueItem> (packet, peekedHdr));
                       newPacket->AddHeader (peekedHdr);
                       AddWifiMacTrailer (newPacket);
                       edcaIt->second->GetMpduAggregator ()->Aggregate (newPacket, currentAggregatedPacket);
@@ -1124,7 +1124,7 @@ private:
   EventId m_endTxNoAckEvent;            //!< Event for finishing transmission that does not require ACK
   EventId m_navCounterResetCtsMissed;   //!< Event to reset NAV when CTS is not received
 
-  Ptr<Packet> m_currentPacket;              //!< Current packet transmitted/to be transmitted
+  Ptr<const Packet> m_currentPacket;        //!< Current packet transmitted/to be transmitted
   WifiMacHeader m_currentHdr;               //!< Header of the current transmitted packet
   Ptr<DcaTxop> m_currentDca;                //!< Current DCA
   WifiMacHeader m_lastReceivedHdr;          //!< Header of the last received packet
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "tabulated-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model to tabulate. A NistErrorRateModel is used if none is given.",
+                   PointerValue (),
+                   MakePointerAccessor (&TabulatedErrorRateModel::SetErrorRateModel,
+                                        &TabulatedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnrDb",
+                   "The lowest SNR of the tables, in dB.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_minSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnrDb",
+                   "The highest SNR of the tables, in dB.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_maxSnrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Resolution",
+                   "The SNR step of the tables, in dB.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::m_resolution),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TabulatedErrorRateModel::~TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TabulatedErrorRateModel::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_model == 0)
+    {
+      m_model = CreateObject<NistErrorRateModel> ();
+    }
+  ErrorRateModel::NotifyConstructionCompleted ();
+}
+
+void
+TabulatedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TabulatedErrorRateModel::SetErrorRateModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+TabulatedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_model;
+}
+
+uint64_t
+TabulatedErrorRateModel::GetTableKey (WifiMode mode, const WifiTxVector &txVector)
+{
+  return (static_cast<uint64_t> (mode.GetUid ()) << 32)
+         | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+         | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 8)
+         | txVector.GetNss ();
+}
+
+const std::vector<double> &
+TabulatedErrorRateModel::BuildTable (WifiMode mode, WifiTxVector txVector) const
+{
+  NS_LOG_FUNCTION (this << mode);
+  NS_ASSERT_MSG (m_maxSnrDb > m_minSnrDb, "Empty SNR range");
+  std::vector<double> &table = m_tables[GetTableKey (mode, txVector)];
+  uint32_t n = static_cast<uint32_t> (std::ceil ((m_maxSnrDb - m_minSnrDb) / m_resolution)) + 1;
+  table.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_resolution) / 10.0);
+      // the chunk success rate is (1 - p)^nbits, store log (-log (1 - p))
+      double psr = m_model->GetChunkSuccessRate (mode, txVector, snr, 1);
+      double p = std::min (std::max (-std::log (psr), 1e-300), 1e300);
+      table.push_back (std::log (p));
+    }
+  return table;
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits);
+  double x = (10.0 * std::log10 (snr) - m_minSnrDb) / m_resolution;
+  std::map<uint64_t, std::vector<double> >::const_iterator it = m_tables.find (GetTableKey (mode, txVector));
+  const std::vector<double> &table = (it != m_tables.end ()) ? it->second : BuildTable (mode, txVector);
+  if (!(x >= 0) || x >= table.size () - 1)
+    {
+      // outside of the table, or snr = 0
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double frac = x - i;
+  double logP = table[i] + frac * (table[i + 1] - table[i]);
+  return std::exp (-std::exp (logP) * nbits);
+}
+
+} //namespace ns3
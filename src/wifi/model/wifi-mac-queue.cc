@@ -138,6 +138,29 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
+template<>
+void
+WifiMacQueue::RemoveFromIndex (ConstIterator pos)
+{
+  const WifiMacHeader &hdr = (*pos)->GetHeader ();
+  if (!hdr.IsQosData ())
+    {
+      return;
+    }
+  Index::iterator i = m_index.find (IndexKey (hdr.GetAddr1 (), hdr.GetQosTid ()));
+  NS_ASSERT (i != m_index.end ());
+  // the item is usually the first of its receiver and TID
+  for (std::list<ConstIterator>::iterator j = i->second.begin (); j != i->second.end (); j++)
+    {
+      if (*j == pos)
+        {
+          i->second.erase (j);
+          return;
+        }
+    }
+  NS_FATAL_ERROR ("Item not found in the index");
+}
+
 template<>
 bool
 WifiMacQueue::TtlExceeded (ConstIterator &it)
@@ -149,12 +172,57 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
       NS_LOG_DEBUG ("Removing packet that stayed in the queue for too long (" <<
                     Simulator::Now () - (*it)->GetTimeStamp () << ")");
       auto curr = it++;
+      RemoveFromIndex (curr);
       DoRemove (curr);
       return true;
     }
   return false;
 }
 
+template<>
+bool
+WifiMacQueue::DoEnqueueIndexed (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  bool atHead = (pos == Head ());
+  if (!DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  const WifiMacHeader &hdr = item->GetHeader ();
+  if (hdr.IsQosData ())
+    {
+      std::list<ConstIterator> &items = m_index[IndexKey (hdr.GetAddr1 (), hdr.GetQosTid ())];
+      // the item is inserted before pos
+      if (atHead)
+        {
+          items.push_front (--pos);
+        }
+      else
+        {
+          items.push_back (--pos);
+        }
+    }
+  return true;
+}
+
+template<>
+void
+WifiMacQueue::RemoveExpired (std::list<ConstIterator> &items)
+{
+  // the lists of the index are kept when they become empty, so that items
+  // remains valid while its expired items are removed
+  while (!items.empty ())
+    {
+      ConstIterator it = items.front ();
+      if (!TtlExceeded (it))
+        {
+          return;
+        }
+    }
+}
+
 template<>
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
@@ -174,10 +242,11 @@ WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
   if (GetNPackets () == GetMaxPackets () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
+      RemoveFromIndex (Head ());
       DoRemove (Head ());
     }
 
-  return DoEnqueue (Tail (), item);
+  return DoEnqueueIndexed (Tail (), item);
 }
 
 template<>
@@ -199,10 +268,11 @@ WifiMacQueue::PushFront (Ptr<WifiMacQueueItem> item)
   if (GetNPackets () == GetMaxPackets () && m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
+      RemoveFromIndex (Head ());
       DoRemove (Head ());
     }
 
-  return DoEnqueue (Head (), item);
+  return DoEnqueueIndexed (Head (), item);
 }
 
 template<>
@@ -215,6 +285,7 @@ WifiMacQueue::Dequeue (void)
     {
       if (!TtlExceeded (it))
         {
+          RemoveFromIndex (it);
           return DoDequeue (it);
         }
     }
@@ -229,6 +300,23 @@ WifiMacQueue::DequeueByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      Index::iterator i = m_index.find (IndexKey (dest, tid));
+      if (i != m_index.end ())
+        {
+          RemoveExpired (i->second);
+          if (!i->second.empty ())
+            {
+              ConstIterator it = i->second.front ();
+              RemoveFromIndex (it);
+              return DoDequeue (it);
+            }
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -236,6 +324,7 @@ WifiMacQueue::DequeueByTidAndAddress (uint8_t tid,
           if ((*it)->GetHeader ().IsQosData () && (*it)->GetAddress (type) == dest &&
               (*it)->GetHeader ().GetQosTid () == tid)
             {
+              RemoveFromIndex (it);
               return DoDequeue (it);
             }
 
@@ -259,6 +348,7 @@ WifiMacQueue::DequeueFirstAvailable (const QosBlockedDestinations *blockedPacket
           if (!(*it)->GetHeader ().IsQosData ()
               || !blockedPackets->IsBlocked ((*it)->GetHeader ().GetAddr1 (), (*it)->GetHeader ().GetQosTid ()))
             {
+              RemoveFromIndex (it);
               return DoDequeue (it);
             }
 
@@ -284,6 +374,21 @@ WifiMacQueue::PeekByTidAndAddress (uint8_t tid,
 {
   NS_LOG_FUNCTION (this << dest);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      Index::iterator i = m_index.find (IndexKey (dest, tid));
+      if (i != m_index.end ())
+        {
+          RemoveExpired (i->second);
+          if (!i->second.empty ())
+            {
+              return DoPeek (i->second.front ());
+            }
+        }
+      NS_LOG_DEBUG ("The queue is empty");
+      return 0;
+    }
+
   for (auto it = Head (); it != Tail (); )
     {
       if (!TtlExceeded (it))
@@ -334,6 +439,7 @@ WifiMacQueue::Remove (void)
     {
       if (!TtlExceeded (it))
         {
+          RemoveFromIndex (it);
           return DoRemove (it);
         }
     }
@@ -353,6 +459,7 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
         {
           if ((*it)->GetPacket () == packet)
             {
+              RemoveFromIndex (it);
               DoRemove (it);
               return true;
             }
@@ -371,6 +478,18 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
 {
   NS_LOG_FUNCTION (this << addr);
 
+  if (type == WifiMacHeader::ADDR1)
+    {
+      Index::iterator i = m_index.find (IndexKey (addr, tid));
+      if (i == m_index.end ())
+        {
+          return 0;
+        }
+      RemoveExpired (i->second);
+      NS_LOG_DEBUG ("returns " << i->second.size ());
+      return i->second.size ();
+    }
+
   uint32_t nPackets = 0;
 
   for (auto it = Head (); it != Tail (); )
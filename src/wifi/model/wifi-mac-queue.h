@@ -24,6 +24,8 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <map>
+#include <list>
 #include "ns3/queue.h"
 #include "wifi-mac-header.h"
 
@@ -144,6 +146,11 @@ private:
  * \endcode
  *
  * in their header file.
+ *
+ * The QoS data packets are also indexed by receiver address (Address 1)
+ * and TID, in the order of the queue, so that the methods looking for the
+ * packets of a receiver and a TID with WifiMacHeader::ADDR1 do not scan the
+ * packets sent to the other receivers.
  */
 template <typename Item>
 class WifiQueue : public Queue<Item>
@@ -305,8 +312,38 @@ private:
    */
   bool TtlExceeded (typename Queue<Item>::ConstIterator &it);
 
+  /// The receiver address and the TID of a QoS data packet
+  typedef std::pair<Mac48Address, uint8_t> IndexKey;
+  /// The positions in the queue of the QoS data packets of each receiver and TID
+  typedef std::map<IndexKey, std::list<typename Queue<Item>::ConstIterator> > Index;
+
+  /**
+   * Enqueue an item at the given position (either the head or the tail of
+   * the queue), and index it.
+   *
+   * \param pos the position of the item
+   * \param item the item
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueueIndexed (typename Queue<Item>::ConstIterator pos, Ptr<Item> item);
+  /**
+   * Remove an item from the index, before it is dequeued or removed from
+   * the queue.
+   *
+   * \param pos the position of the item
+   */
+  void RemoveFromIndex (typename Queue<Item>::ConstIterator pos);
+  /**
+   * Remove the items of the given index list which have been in the queue
+   * for too long, from the head of the list.
+   *
+   * \param items the positions of the items with a given receiver and TID
+   */
+  void RemoveExpired (std::list<typename Queue<Item>::ConstIterator> &items);
+
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  Index m_index;                            //!< Index of the QoS data packets
 };
 
 /// Declare WifiMacQueue as a specialization of template class WifiQueue
@@ -2216,9 +2216,28 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
     }
 }
 
+uint64_t
+WifiPhy::GetTxVectorKey (const WifiTxVector &txVector)
+{
+  NS_ASSERT (txVector.GetNss () < 16 && txVector.GetNess () < 8 && txVector.GetGuardInterval () % 100 == 0);
+  return (static_cast<uint64_t> (txVector.GetMode ().GetUid ()) << 32)
+         | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+         | (static_cast<uint64_t> (txVector.GetPreambleType ()) << 16)
+         | (static_cast<uint64_t> (txVector.GetGuardInterval () / 100) << 8)
+         | (static_cast<uint64_t> (txVector.GetNss ()) << 4)
+         | (static_cast<uint64_t> (txVector.GetNess ()) << 1)
+         | (txVector.IsStbc () ? 1 : 0);
+}
+
 Time
 WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
 {
+  uint64_t key = GetTxVectorKey (txVector);
+  std::map<uint64_t, Time>::const_iterator it = m_plcpDurationCache.find (key);
+  if (it != m_plcpDurationCache.end ())
+    {
+      return it->second;
+    }
   WifiPreamble preamble = txVector.GetPreambleType ();
   Time duration = GetPlcpPreambleDuration (txVector)
     + GetPlcpHeaderDuration (txVector)
@@ -2227,14 +2246,34 @@ WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
     + GetPlcpSigA2Duration (preamble)
     + GetPlcpTrainingSymbolDuration (txVector)
     + GetPlcpSigBDuration (preamble);
+  m_plcpDurationCache.insert (std::make_pair (key, duration));
   return duration;
 }
 
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
+  if (mpdutype != NORMAL_MPDU)
+    {
+      // the duration of an MPDU in an A-MPDU depends on the previous MPDUs
+      Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
+        + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+      return duration;
+    }
+  std::pair<uint64_t, uint64_t> key (GetTxVectorKey (txVector), (static_cast<uint64_t> (size) << 16) | frequency);
+  std::map<std::pair<uint64_t, uint64_t>, Time>::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      return it->second;
+    }
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  if (m_txDurationCache.size () >= 10000)
+    {
+      // bound the memory used when many different sizes are sent
+      m_txDurationCache.clear ();
+    }
+  m_txDurationCache.insert (std::make_pair (key, duration));
   return duration;
 }
 
@@ -353,6 +353,9 @@ public:
    * \param frequency the channel center frequency (MHz)
    *
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
+   *
+   * The durations are computed once for each combination of size,
+   * TXVECTOR and frequency, and then taken from a cache.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency);
   /**
@@ -1926,6 +1929,16 @@ private:
   uint8_t              m_initialChannelNumber;     //!< Initial channel number
 
   Time m_channelSwitchDelay;     //!< Time required to switch between channel
+
+  /**
+   * \param txVector the TXVECTOR
+   * \return the fields of the TXVECTOR the durations depend on, packed in an integer
+   */
+  static uint64_t GetTxVectorKey (const WifiTxVector &txVector);
+
+  std::map<uint64_t, Time> m_plcpDurationCache;  //!< Preamble and header durations, by TXVECTOR key
+  /// Durations of the PPDUs which are not A-MPDUs, by TXVECTOR key and (size, frequency)
+  std::map<std::pair<uint64_t, uint64_t>, Time> m_txDurationCache;
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
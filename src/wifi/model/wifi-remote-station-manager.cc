@@ -421,14 +421,10 @@ WifiRemoteStationManager::DoDispose (void)
 {
   for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
-      delete (*i);
+      delete i->second;
     }
   m_states.clear ();
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
-    {
-      delete (*i);
-    }
-  m_stations.clear ();
+  DeleteStations ();
 }
 
 void
@@ -1643,13 +1639,11 @@ WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  StationStates::const_iterator it = m_states.find (address);
+  if (it != m_states.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return it->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1668,7 +1662,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_htSupported = false;
   state->m_vhtSupported = false;
   state->m_heSupported = false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_states[address] = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1692,13 +1686,10 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << (uint16_t)tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  std::vector<WifiRemoteStation *> &stations = const_cast<WifiRemoteStationManager *> (this)->m_stations[address];
+  if (tid < stations.size () && stations[tid] != 0)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return stations[tid];
     }
   WifiRemoteStationState *state = LookupState (address);
 
@@ -1707,7 +1698,11 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
-  const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  if (tid >= stations.size ())
+    {
+      stations.resize (tid + 1, 0);
+    }
+  stations[tid] = station;
   return station;
 }
 
@@ -1808,14 +1803,23 @@ WifiRemoteStationManager::GetDefaultMcs (void) const
 }
 
 void
-WifiRemoteStationManager::Reset (void)
+WifiRemoteStationManager::DeleteStations (void)
 {
-  NS_LOG_FUNCTION (this);
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
-      delete (*i);
+      for (std::vector<WifiRemoteStation *>::const_iterator j = i->second.begin (); j != i->second.end (); j++)
+        {
+          delete (*j);
+        }
     }
   m_stations.clear ();
+}
+
+void
+WifiRemoteStationManager::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  DeleteStations ();
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear ();
@@ -26,6 +26,8 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "wifi-tx-vector.h"
 #include "ht-capabilities.h"
 #include "vht-capabilities.h"
@@ -1446,15 +1448,19 @@ private:
    * \return the number of fragments needed
    */
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
+  /**
+   * Delete all the WifiRemoteStations.
+   */
+  void DeleteStations (void);
 
   /**
-   * A vector of WifiRemoteStations
+   * A hash map of the WifiRemoteStations of each address, indexed by TID
    */
-  typedef std::vector <WifiRemoteStation *> Stations;
+  typedef sgi::hash_map <Mac48Address, std::vector<WifiRemoteStation *>, Mac48AddressHash> Stations;
   /**
-   * A vector of WifiRemoteStationStates
+   * A hash map of WifiRemoteStationStates, by address
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  typedef sgi::hash_map <Mac48Address, WifiRemoteStationState *, Mac48AddressHash> StationStates;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -18,9 +18,11 @@
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <algorithm>
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
@@ -47,11 +49,24 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which receivers are ignored. "
+                   "Zero means that all the receivers get every transmission.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("IndexRefreshPeriod",
+                   "The period at which the positions of the moving receivers are "
+                   "reindexed, when MaxRange is set.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&YansWifiChannel::m_indexRefreshPeriod),
+                   MakeTimeChecker (Seconds (0), Time::Max ()))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -62,6 +77,14 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_index = 0;
+  Channel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
@@ -80,38 +103,80 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  if (m_maxRange == 0)
     {
-      if (sender != (*i))
+      for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
-
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+          AddReceiver (sender, *i);
+        }
+    }
+  else
+    {
+      if (m_index == 0 || m_index->GetN () != m_phyList.size ())
+        {
+          m_index = Create<MobilityGrid> (m_maxRange, m_indexRefreshPeriod);
+          for (uint32_t i = 0; i < m_phyList.size (); i++)
             {
-              dstNode = 0xffffffff;
+              m_index->Add (m_phyList[i]->GetMobility (), i);
             }
-          else
+        }
+      m_candidates.clear ();
+      m_index->GetCandidates (senderMobility->GetPosition (), m_maxRange, m_candidates);
+      // keep the receptions in the order of the phy list
+      std::sort (m_candidates.begin (), m_candidates.end ());
+      for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+        {
+          Ptr<YansWifiPhy> receiver = m_phyList[*i];
+          if (senderMobility->GetDistanceFrom (receiver->GetMobility ()) <= m_maxRange)
             {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
+              AddReceiver (sender, receiver);
             }
+        }
+    }
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          (*i), copy, rxPowerDbm, duration);
+  if (m_receivers.empty ())
+    {
+      return;
+    }
+  m_loss->CalcRxPowerBatch (txPowerDbm, senderMobility, m_receiverMobilities, m_rxPowersDbm);
+  for (uint32_t i = 0; i < m_receivers.size (); i++)
+    {
+      Ptr<YansWifiPhy> receiver = m_receivers[i];
+      Ptr<MobilityModel> receiverMobility = m_receiverMobilities[i];
+      Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      double rxPowerDbm = m_rxPowersDbm[i];
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      Ptr<Packet> copy = packet->Copy ();
+      Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+      uint32_t dstNode;
+      if (dstNetDevice == 0)
+        {
+          dstNode = 0xffffffff;
         }
+      else
+        {
+          dstNode = dstNetDevice->GetNode ()->GetId ();
+        }
+
+      Simulator::ScheduleWithContext (dstNode,
+                                      delay, &YansWifiChannel::Receive, this,
+                                      receiver, copy, rxPowerDbm, duration);
+    }
+  m_receivers.clear ();
+  m_receiverMobilities.clear ();
+}
+
+void
+YansWifiChannel::AddReceiver (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver) const
+{
+  //For now don't account for inter channel interference nor channel bonding
+  if (sender == receiver || receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
     }
+  m_receivers.push_back (receiver);
+  m_receiverMobilities.push_back (receiver->GetMobility ()->GetObject<MobilityModel> ());
 }
 
 void
@@ -148,4 +213,12 @@ YansWifiChannel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+double
+YansWifiChannel::ComputeMaxRange (double txPowerDbm, double thresholdDbm) const
+{
+  NS_LOG_FUNCTION (this << txPowerDbm << thresholdDbm);
+  NS_ASSERT (m_loss != 0);
+  return m_loss->CalcMaxDistance (txPowerDbm, thresholdDbm);
+}
+
 } //namespace ns3
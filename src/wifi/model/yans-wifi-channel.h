@@ -22,6 +22,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/mobility-grid.h"
 #include "yans-wifi-phy.h"
 
 namespace ns3 {
@@ -38,6 +39,16 @@ class PropagationDelayModel;
  * class and supports an ns3::PropagationLossModel and an 
  * ns3::PropagationDelayModel.  By default, no propagation models are set; 
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * If the MaxRange attribute is set, the receivers further than this
+ * distance from the sender are ignored: no propagation loss is computed
+ * and no reception is scheduled for them.  The receivers are found through
+ * a ns3::MobilityGrid over their positions, which is built at the first
+ * transmission following the addition of a YansWifiPhy to the channel, so
+ * the mobility models of the phys must notify all their course changes
+ * (e.g., ConstantAccelerationMobilityModel cannot be used).  The range
+ * matching a receive power threshold can be obtained from
+ * ComputeMaxRange.
  */
 class YansWifiChannel : public Channel
 {
@@ -95,6 +106,22 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Compute the distance at which the receive power falls below a threshold
+   *
+   * See PropagationLossModel::CalcMaxDistance.  The result is meant to be
+   * used as MaxRange, with the largest tx power of the senders and the
+   * energy detection threshold of the receivers, minus their rx gain.
+   *
+   * \param txPowerDbm the tx power, in dBm
+   * \param thresholdDbm the receive power threshold, in dBm
+   *
+   * \return the distance in meters, at most 1e7
+   */
+  double ComputeMaxRange (double txPowerDbm, double thresholdDbm) const;
+
+protected:
+  virtual void DoDispose (void);
 
 private:
   /**
@@ -113,10 +140,25 @@ private:
    * \param duration the transmission duration associated with the packet being sent
    */
   void Receive (Ptr<YansWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration) const;
+  /**
+   * Add a receiver of the packet being sent, unless it is the sender or
+   * it is tuned to another channel
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param receiver the receiver
+   */
+  void AddReceiver (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Maximum distance of the receivers, 0 if unlimited
+  Time m_indexRefreshPeriod;           //!< Refresh period of the receiver index
+  mutable Ptr<MobilityGrid> m_index;   //!< Index of the receiver positions
+  mutable std::vector<uint32_t> m_candidates; //!< Receivers returned by the index
+  mutable PhyList m_receivers;         //!< Receivers of the packet being sent
+  mutable std::vector<Ptr<MobilityModel> > m_receiverMobilities; //!< Mobility models of the receivers
+  mutable std::vector<double> m_rxPowersDbm;  //!< Rx powers of the receivers, in dBm
 };
 
 } //namespace ns3
@@ -175,6 +175,15 @@ TxDurationTest::CheckTxDuration (uint32_t size, WifiMode payloadMode, uint32_t c
                 << std::endl;
       return false;
     }
+  //the second computation is taken from the cache of the phy
+  if (phy->CalculateTxDuration (size, txVector, testedFrequency) != knownDuration)
+    {
+      std::cerr << "size=" << size
+                << " mode=" << payloadMode
+                << " cached duration differs from " << knownDuration
+                << std::endl;
+      return false;
+    }
   if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HE)
     {
       //Durations vary depending on frequency; test also 2.4 GHz (bug 1971)
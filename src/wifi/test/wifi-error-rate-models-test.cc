@@ -21,6 +21,9 @@
 #include <cmath>
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+#include "ns3/pointer.h"
 
 using namespace ns3;
 
@@ -289,6 +292,69 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Tabulated
+ *
+ * Check that the chunk success rates of TabulatedErrorRateModel are within
+ * 1e-3 of those of the NIST and YANS models it tabulates.
+ */
+class WifiErrorRateModelsTestCaseTabulated : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTabulated ();
+  virtual ~WifiErrorRateModelsTestCaseTabulated ();
+
+private:
+  virtual void DoRun (void);
+};
+
+WifiErrorRateModelsTestCaseTabulated::WifiErrorRateModelsTestCaseTabulated ()
+  : TestCase ("WifiErrorRateModel test case tabulated")
+{
+}
+
+WifiErrorRateModelsTestCaseTabulated::~WifiErrorRateModelsTestCaseTabulated ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::DoRun (void)
+{
+  const char *modes[] = { "DsssRate1Mbps", "DsssRate11Mbps", "OfdmRate6Mbps", "OfdmRate9Mbps",
+                          "OfdmRate18Mbps", "OfdmRate36Mbps", "OfdmRate54Mbps", "HtMcs7",
+                          "VhtMcs8", "VhtMcs9", "HeMcs10", "HeMcs11" };
+  uint32_t sizes[] = { 8, 1500 * 8, 65535 * 8 };
+  Ptr<ErrorRateModel> analyticModels[] = { CreateObject<NistErrorRateModel> (), CreateObject<YansErrorRateModel> () };
+
+  for (uint32_t m = 0; m < 2; ++m)
+    {
+      Ptr<ErrorRateModel> analytic = analyticModels[m];
+      Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+      tabulated->SetErrorRateModel (analytic);
+      for (uint32_t i = 0; i < sizeof (modes) / sizeof (modes[0]); ++i)
+        {
+          WifiMode mode (modes[i]);
+          // VHT MCS 9 is not allowed at 20 MHz
+          WifiTxVector txVector;
+          txVector.SetChannelWidth (mode.GetModulationClass () == WIFI_MOD_CLASS_VHT ? 40 : 20);
+          for (double snrDb = -12.0; snrDb < 45.0; snrDb += 0.173)
+            {
+              double snr = std::pow (10.0, snrDb / 10.0);
+              for (uint32_t j = 0; j < sizeof (sizes) / sizeof (sizes[0]); ++j)
+                {
+                  double expected = analytic->GetChunkSuccessRate (mode, txVector, snr, sizes[j]);
+                  double ps = tabulated->GetChunkSuccessRate (mode, txVector, snr, sizes[j]);
+                  NS_TEST_ASSERT_MSG_EQ_TOL (ps, expected, 1e-3, "Wrong success rate for " << mode
+                                             << " at " << snrDb << " dB with " << sizes[j] << " bits");
+                }
+            }
+        }
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -306,6 +372,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTabulated, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
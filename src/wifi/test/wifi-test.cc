@@ -28,7 +28,10 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -1154,6 +1157,320 @@ Bug2222TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_countInternalCollisions, 1, "unexpected number of internal collisions!");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Propagation loss model counting the receivers it is evaluated for
+ */
+class CountingPropagationLossModel : public PropagationLossModel
+{
+public:
+  CountingPropagationLossModel ();
+
+  std::vector<uint32_t> m_calls; ///< number of evaluations, per receiver node
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+};
+
+CountingPropagationLossModel::CountingPropagationLossModel ()
+  : m_calls (5, 0)
+{
+}
+
+double
+CountingPropagationLossModel::DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  const_cast<CountingPropagationLossModel *> (this)->m_calls[b->GetObject<Node> ()->GetId ()]++;
+  // far below the energy detection threshold
+  return txPowerDbm - 200;
+}
+
+int64_t
+CountingPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  return 0;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that YansWifiChannel ignores the receivers beyond MaxRange
+ *
+ * Node 0 broadcasts a frame at 1s and at 9.5s.  Nodes 1 and 2 are within
+ * 100m, node 3 is 1km away, and node 4 moves towards node 0 from 1km away
+ * at 100m/s, so it is within range at the second transmission only.
+ * The index is not refreshed during the simulation, so that node 4 is
+ * only found thanks to the margin for its motion.
+ */
+class YansWifiChannelMaxRangeTest : public TestCase
+{
+public:
+  YansWifiChannelMaxRangeTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a broadcast frame
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<NetDevice> dev);
+};
+
+YansWifiChannelMaxRangeTest::YansWifiChannelMaxRangeTest ()
+  : TestCase ("Check the receiver culling of YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelMaxRangeTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  dev->Send (Create<Packet> (100), dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMaxRangeTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (5);
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+  channel->SetAttribute ("IndexRefreshPeriod", TimeValue (Seconds (100)));
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (10.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.0, -60.0, 0.0));
+  positionAlloc->Add (Vector (1000.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (NodeContainer (nodes.Get (0), nodes.Get (1), nodes.Get (2), nodes.Get (3)));
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (1000.0, 0.0, 0.0));
+  moving->SetVelocity (Vector (-100.0, 0.0, 0.0));
+  nodes.Get (4)->AggregateObject (moving);
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelMaxRangeTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Schedule (Seconds (9.5), &YansWifiChannelMaxRangeTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+
+  uint32_t expected[5] = { 0, 2, 2, 0, 1 };
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (loss->m_calls[i], expected[i], "Unexpected number of receptions at node " << i);
+    }
+
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  channel->SetPropagationLossModel (friis);
+  double range = channel->ComputeMaxRange (16.0206, -96);
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (range, 0.0, 0.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (friis->CalcRxPower (16.0206, a, b), -96, 0.01, "Wrong range " << range);
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check the receiver culling of YansWifiChannel with two phys
+ * sharing the mobility model of their node
+ *
+ * Node 0 broadcasts a frame at 1s and at 3s.  Node 1 has two phys on the
+ * channel and is 10m away, then moves 1km away at 2s; node 2 stays 50m
+ * away.  Both phys of node 1 must receive the first frame and none the
+ * second one, so the course change of node 1 must move both of them in
+ * the index.
+ */
+class YansWifiChannelSharedMobilityTest : public TestCase
+{
+public:
+  YansWifiChannelSharedMobilityTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send a broadcast frame
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<NetDevice> dev);
+};
+
+YansWifiChannelSharedMobilityTest::YansWifiChannelSharedMobilityTest ()
+  : TestCase ("Check the receiver culling of YansWifiChannel with two phys on a node")
+{
+}
+
+void
+YansWifiChannelSharedMobilityTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  dev->Send (Create<Packet> (100), dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelSharedMobilityTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<CountingPropagationLossModel> loss = CreateObject<CountingPropagationLossModel> ();
+  channel->SetPropagationLossModel (loss);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+  channel->SetAttribute ("IndexRefreshPeriod", TimeValue (Seconds (100)));
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.Install (phy, mac, nodes.Get (1));
+  NS_TEST_ASSERT_MSG_EQ (nodes.Get (1)->GetNDevices (), 2, "Node 1 should have two devices");
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (10.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.0, 50.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<MobilityModel> node1 = nodes.Get (1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelSharedMobilityTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, node1, Vector (1000.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelSharedMobilityTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+
+  uint32_t expected[3] = { 0, 2, 2 };
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (loss->m_calls[i], expected[i], "Unexpected number of receptions at node " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check the lookups of WifiMacQueue by receiver and TID
+ *
+ * QoS data packets for two receivers and two TIDs are enqueued, along with
+ * a non-QoS packet, then removed through the different methods of the
+ * queue, and the packets found for each receiver and TID are checked.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Create a queue item
+   * \param addr1 the receiver address
+   * \param tid the TID, or a negative value for a non-QoS packet
+   * \param size the packet size
+   * \returns the item
+   */
+  Ptr<WifiMacQueueItem> CreateItem (Mac48Address addr1, int tid, uint32_t size);
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Check the lookups of WifiMacQueue by receiver and TID")
+{
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueIndexTest::CreateItem (Mac48Address addr1, int tid, uint32_t size)
+{
+  WifiMacHeader hdr;
+  if (tid < 0)
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (tid);
+    }
+  hdr.SetAddr1 (addr1);
+  return Create<WifiMacQueueItem> (Create<Packet> (size), hdr);
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  Mac48Address a ("00:00:00:00:00:01");
+  Mac48Address b ("00:00:00:00:00:02");
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+
+  // sizes identify the packets
+  queue->Enqueue (CreateItem (a, 0, 100));
+  queue->Enqueue (CreateItem (b, 0, 101));
+  queue->Enqueue (CreateItem (a, 1, 102));
+  queue->Enqueue (CreateItem (a, 0, 103));
+  queue->Enqueue (CreateItem (a, -1, 104));
+  queue->PushFront (CreateItem (a, 0, 105));
+
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 3, "Wrong number of packets for a, TID 0");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (1, WifiMacHeader::ADDR1, a), 1, "Wrong number of packets for a, TID 1");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, b), 1, "Wrong number of packets for b, TID 0");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (1, WifiMacHeader::ADDR1, b), 0, "Wrong number of packets for b, TID 1");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (0, WifiMacHeader::ADDR1, a)->GetPacket ()->GetSize (), 105, "The packet pushed to the front is not first");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetPacket ()->GetSize (), 105, "Wrong packet at the head of the queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueByTidAndAddress (0, WifiMacHeader::ADDR1, a)->GetPacket ()->GetSize (), 100, "Wrong first packet for a, TID 0");
+  Ptr<const Packet> last = queue->PeekByTidAndAddress (0, WifiMacHeader::ADDR1, a)->GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (last->GetSize (), 103, "Wrong second packet for a, TID 0");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (last), true, "The packet was not removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, a), 0, "The removed packets are still found");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (0, WifiMacHeader::ADDR1, a), 0, "The removed packets are still found");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetPacket ()->GetSize (), 101, "Wrong packet at the head of the queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (0, WifiMacHeader::ADDR1, b), 0, "The dequeued packet is still found");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueByTidAndAddress (1, WifiMacHeader::ADDR1, a)->GetPacket ()->GetSize (), 102, "Wrong packet for a, TID 1");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 1, "Only the non-QoS packet should be left");
+
+  // the packets which stayed in the queue for too long are not found
+  queue->Enqueue (CreateItem (b, 2, 106));
+  Simulator::Stop (queue->GetMaxDelay () + MilliSeconds (1));
+  Simulator::Run ();
+  queue->Enqueue (CreateItem (b, 2, 107));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPacketsByTidAndAddress (2, WifiMacHeader::ADDR1, b), 1, "The expired packet is still counted");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekByTidAndAddress (2, WifiMacHeader::ADDR1, b)->GetPacket ()->GetSize (), 107, "The expired packet is still found");
+  queue->Flush ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1176,6 +1493,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new SetChannelFrequencyTest, TestCase::QUICK);
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
+  AddTestCase (new YansWifiChannelMaxRangeTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSharedMobilityTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a text fading trace, such as the ones written by
+// src/lte/model/fading-traces/fading_trace_generator.m, to the binary
+// format of FadingTrace, which TraceFadingLossModel and the trace fading
+// models of the propagation and spectrum modules map in memory:
+//
+//   ./waf --run "convert-fading-trace --input=fading_trace_EPA_3kmph.fad
+//                --output=fading_trace_EPA_3kmph.bin --rows=100 --samples=10000"
+//
+// Without --input, a Rayleigh fading trace of the given dimensions is
+// generated with a Jakes model instead.
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/fading-trace.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rows = 100;
+  uint32_t samples = 10000;
+  Time period = MilliSeconds (1);
+  double dopplerHz = 10;
+  uint32_t oscillators = 16;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a text fading trace to a binary one, or generate a binary fading trace");
+  cmd.AddValue ("input", "text trace file, or empty to generate the trace", input);
+  cmd.AddValue ("output", "binary trace file", output);
+  cmd.AddValue ("rows", "number of rows (e.g., RBs) of the trace", rows);
+  cmd.AddValue ("samples", "number of samples of each row", samples);
+  cmd.AddValue ("period", "sample period", period);
+  cmd.AddValue ("doppler", "maximum Doppler frequency of a generated trace, in Hz", dopplerHz);
+  cmd.AddValue ("oscillators", "number of sinusoids of a generated trace", oscillators);
+  cmd.Parse (argc, argv);
+
+  if (output.empty () || rows == 0 || samples == 0 || oscillators == 0 || !period.IsStrictlyPositive ())
+    {
+      std::cerr << "An output file and positive dimensions are required" << std::endl;
+      return 1;
+    }
+
+  Ptr<const FadingTrace> trace;
+  if (input.empty ())
+    {
+      trace = FadingTrace::Generate (rows, samples, period, dopplerHz, oscillators,
+                                     CreateObject<UniformRandomVariable> ());
+    }
+  else
+    {
+      trace = FadingTrace::LoadText (input, rows, samples, period);
+      if (trace == 0)
+        {
+          std::cerr << "Unable to read " << rows << " rows of " << samples << " samples from " << input << std::endl;
+          return 1;
+        }
+    }
+  if (!trace->Save (output))
+    {
+      std::cerr << "Unable to write " << output << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a binary trace file, written by the default ascii trace sinks
+// to a stream created with AsciiTraceHelper::CreateBinaryFileStream, to
+// text.  Each record becomes one line:
+//
+//   <type> <time in seconds> /NodeList/<node>/DeviceList/<device> uid=<uid> size=<size> [bytes]
+//
+// or, with --csv, one comma separated line per record.
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "ns3/command-line.h"
+#include "ns3/binary-trace.h"
+
+using namespace ns3;
+
+/**
+ * Print a node or device id
+ * \param os the output stream
+ * \param id the id
+ */
+static void
+PrintId (std::ostream &os, uint32_t id)
+{
+  if (id == BinaryTraceRecord::NO_ID)
+    {
+      os << "*";
+    }
+  else
+    {
+      os << id;
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename;
+  bool csv = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file to text");
+  cmd.AddValue ("file", "binary trace file", filename);
+  cmd.AddValue ("csv", "print comma separated values", csv);
+  cmd.Parse (argc, argv);
+
+  if (filename.empty ())
+    {
+      std::cerr << "No binary trace file given (--file)" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  BinaryTraceReader reader;
+  if (!reader.Open (filename))
+    {
+      std::cerr << "Unable to read binary trace file " << filename << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout << std::setprecision (9) << std::fixed;
+  if (csv)
+    {
+      std::cout << "type,time,node,device,uid,size,bytes\n";
+    }
+
+  BinaryTraceRecord record;
+  while (reader.Read (record))
+    {
+      double seconds = record.m_time / 1e9;
+      if (csv)
+        {
+          std::cout << record.m_type << "," << seconds << ",";
+          PrintId (std::cout, record.m_node);
+          std::cout << ",";
+          PrintId (std::cout, record.m_device);
+          std::cout << "," << record.m_uid << "," << record.m_size << ",";
+        }
+      else
+        {
+          std::cout << record.m_type << " " << seconds << " /NodeList/";
+          PrintId (std::cout, record.m_node);
+          std::cout << "/DeviceList/";
+          PrintId (std::cout, record.m_device);
+          std::cout << " uid=" << record.m_uid << " size=" << record.m_size;
+          if (record.m_capLen > 0)
+            {
+              std::cout << " ";
+            }
+        }
+      std::cout << std::hex << std::setfill ('0');
+      for (uint16_t i = 0; i < record.m_capLen; ++i)
+        {
+          std::cout << std::setw (2) << static_cast<uint32_t> (record.m_data[i]);
+        }
+      std::cout << std::dec << std::setfill (' ') << "\n";
+    }
+
+  return EXIT_SUCCESS;
+}